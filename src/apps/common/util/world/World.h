@@ -18,19 +18,34 @@ public:
 	World()
 	: Configurable("simulation"),
 	  iterations(200),
+	  tolerance(0.0),
+	  hinge_relaxation(1.0),
+	  motor_relaxation(1.0),
+	  contact_relaxation(1.0),
 	  dt(0.005),
-	  sim_time(0.0)
+	  sim_time(0.0),
+	  used_iterations(0)
 	{
 		add_interactive_property("dt", dt);
 		add_interactive_property("iterations", iterations);
+		add_interactive_property("tolerance", tolerance);
+		add_interactive_property("hinge relaxation", hinge_relaxation);
+		add_interactive_property("motor relaxation", motor_relaxation);
+		add_interactive_property("contact relaxation", contact_relaxation);
 		add_interactive_property("sim time", sim_time);
+		add_interactive_property("used iterations", used_iterations);
 	}
 	virtual ~World(){};
 
 	int iterations;
+	real_t tolerance;
+	real_t hinge_relaxation;
+	real_t motor_relaxation;
+	real_t contact_relaxation;
 	real_t dt;
 	real_t sim_time;
 
 	int num_contacts;
+	int used_iterations;
 };
 
@@ -42,7 +42,11 @@ void sim_loop(int pause)
 
 //		*x(tFe(sw->mem, 0)) = -10.0;
 
-		step_world(sw->mem, sw->dt, sw->iterations);
+		*relax(sw->mem, TP_RELAX_HINGE) = sw->hinge_relaxation;
+		*relax(sw->mem, TP_RELAX_MOTOR) = sw->motor_relaxation;
+		*relax(sw->mem, TP_RELAX_CONTACT) = sw->contact_relaxation;
+
+		sw->used_iterations = step_world(sw->mem, sw->dt, sw->iterations, sw->tolerance);
 	}
 
 	// draw bodies
@@ -66,6 +70,7 @@ int main(int argc, char **argv)
 
 	create_foot(sw->mem);
 	create_foot_geom(sw->mem, geoms);
+	update_kinematics(sw->mem);
 
 	assert_consistency(sw->mem);
 
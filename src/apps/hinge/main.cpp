@@ -34,7 +34,11 @@ void sim_loop(int pause)
 {
 	if(!pause)
 	{
-		step_world(sw->mem, sw->dt, sw->iterations);
+		*relax(sw->mem, TP_RELAX_HINGE) = sw->hinge_relaxation;
+		*relax(sw->mem, TP_RELAX_MOTOR) = sw->motor_relaxation;
+		*relax(sw->mem, TP_RELAX_CONTACT) = sw->contact_relaxation;
+
+		sw->used_iterations = step_world(sw->mem, sw->dt, sw->iterations, sw->tolerance);
 
 //		real_t rate = hinge_angle_rate(sw->mem, 0);
 //		real_t angle = hinge_angle(sw->mem, 0);
@@ -69,6 +73,7 @@ int main(int argc, char **argv)
 
 	create_hinge_bodies(sw->mem);
 	create_hinge_bodies_geom(sw->mem, geoms);
+	update_kinematics(sw->mem);
 
 	assert_consistency(sw->mem);
 
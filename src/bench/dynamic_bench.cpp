@@ -0,0 +1,139 @@
+/*
+ * dynamic_bench.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/* Times step_world() on a quadruped, a torso and four legs of two links, with
+ * the model size set at compile time, or at runtime if built with TP_DYNAMIC.
+ * Prints the median run time of a number of runs, and the final state, which is
+ * the same for both builds. Usage: dynamic_bench [iterations] [steps] [runs]
+ */
+
+#ifndef TP_DYNAMIC
+#define TP_BODIES	9
+#define TP_HINGES	8
+#define TP_MOTORS	8
+#define TP_FEET		4
+#endif
+
+#include <tp/tp-core.h>
+#include <tp/tp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static void setup_body(struct mem_t *m, int b, real_t px, real_t py, real_t pz, real_t mass, real_t lx, real_t ly, real_t lz)
+{
+	tp_quatern eq = {1.0, 0.0, 0.0, 0.0};
+	tp_mtx33 eR;
+	quaternion_to_rot_mtx33(eq, eR);
+
+	set_quatern(eq, quatern(m, b));
+	set_mtx33(eR, R(m, b));
+
+	*x(pos(m, b)) = px;
+	*y(pos(m, b)) = py;
+	*z(pos(m, b)) = pz;
+
+	set_box_inertia(mass, mi(m, b), lx, ly, lz, Ibi(m, b));
+}
+
+// The torso is body 0, each leg a hip and a shank, the shanks are the feet
+static void setup_quadruped(struct mem_t *m)
+{
+	setup_body(m, 0, 0.0, 0.0, 0.6, 10.0, 1.0, 0.6, 0.2);
+
+	const real_t lx[4] = {0.5, 0.5, -0.5, -0.5}, ly[4] = {0.4, -0.4, 0.4, -0.4};
+	for(int l = 0; l < 4; ++l)
+	{
+		int b = 1 + 2*l, h = 2*l;
+
+		setup_body(m, b, lx[l], ly[l], 0.6, 1.0, 0.1, 0.1, 0.1);
+		tp_vec3 hip_anchor = {lx[l], ly[l], 0.6}, hip_axis = {1.0, 0.0, 0.0};
+		create_hinge(m, h, 0, b, hip_anchor, hip_axis);
+		add_motor(m, h, h, 50.0);
+
+		setup_body(m, b+1, lx[l], ly[l], 0.4, 0.5, 0.1, 0.1, 0.4);
+		tp_vec3 knee_anchor = {lx[l], ly[l], 0.55}, knee_axis = {0.0, 1.0, 0.0};
+		create_hinge(m, h+1, b, b+1, knee_anchor, knee_axis);
+		add_motor(m, h+1, h+1, 50.0);
+	}
+
+	update_kinematics(m);
+}
+
+static void run(struct mem_t *m, int num_iterations, int num_steps)
+{
+	const index_t feet[4] = {2, 4, 6, 8};
+
+	for(int s = 0; s < num_steps; ++s)
+	{
+		int offset = 0;
+		for(int f = 0; f < TP_FEET; ++f)
+			offset += collide_foot_cylinder_tri(m, 0.05, 0.4, offset, feet[f]);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+			*z(tFe(m, b)) += -9.81/_mi(m, b);
+
+		for(int k = 0; k < TP_MOTORS; ++k)
+			*mds(m, k) = 0.2*sin(0.01*s + k);
+
+		step_world(m, 0.005, num_iterations);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int num_iterations = argc > 1 ? atoi(argv[1]) : 20;
+	int num_steps = argc > 2 ? atoi(argv[2]) : 40000;
+	int num_runs = argc > 3 ? atoi(argv[3]) : 9;
+
+#ifdef TP_DYNAMIC
+	size_t size = size_memory(9, 8, 8, 4);
+	void *storage = aligned_alloc(64, (size + 63) & ~(size_t)63);
+	struct mem_t world, *m = &world;
+#else
+	struct mem_t *m = (struct mem_t *)malloc(sizeof(struct mem_t));
+#endif
+
+	std::vector<double> times;
+	for(int r = 0; r < num_runs; ++r)
+	{
+#ifdef TP_DYNAMIC
+		init_memory(m, storage, 9, 8, 8, 4);
+#else
+		zero_memory(m);
+#endif
+		setup_quadruped(m);
+
+		auto start = std::chrono::steady_clock::now();
+		run(m, num_iterations, num_steps);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		times.push_back(elapsed.count());
+	}
+
+	std::sort(times.begin(), times.end());
+
+	printf("%s: median %.3f s, %.3f us/step\n",
+#ifdef TP_DYNAMIC
+			"dynamic",
+#else
+			"static",
+#endif
+			times[num_runs/2], 1e6*times[num_runs/2]/num_steps);
+	printf("torso %.9f %.9f %.9f\n", _x(pos(m, 0)), _y(pos(m, 0)), _z(pos(m, 0)));
+
+#ifdef TP_DYNAMIC
+	free(storage);
+#else
+	free(m);
+#endif
+
+	return 0;
+}
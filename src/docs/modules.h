@@ -24,10 +24,15 @@
  * - set_cylinder_inertia()
  * - create_hinge()
  * - add_motor()
+ * - update_kinematics()
  * - hinge_angle()
  * - hinge_angle_rate()
  * - step_world()
  *
+ * The world inverse inertias and the hinge anchors and axes in world coordinates are
+ * cached per step, see update_kinematics(). Call it once a world has been configured,
+ * and after changing positions, rotations or inertias outside of step_world().
+ *
  * See \ref main-usage for more details how to setup a simulation.
  */
 
@@ -40,6 +45,26 @@
  * a cylindrical foot towards a plane terrain.
  */
 
+/** @defgroup tp-batch Batch Stepping
+ *
+ * Host side functions for stepping many independent simulation worlds on all CPU cores.
+ *
+ * The worlds are spread over a persistent pool of threads, see step_worlds(), or, with
+ * memory/interleaved.h, step_blocks(). The batch
+ * functions use pthreads and are therefore not part of tp.h, include batch.h after tp.h
+ * to use them.
+ */
+
+/** @defgroup tp-world Models as Types
+ *
+ * Host side template API for using several simulation models in one program.
+ *
+ * tp::World compiles the functions of tp.h for a model size given by template
+ * arguments, instead of by #TP_BODIES, #TP_HINGES, #TP_MOTORS and #TP_FEET. Worlds of
+ * different models can be allocated from one arena, see arena_alloc(), and stepped on
+ * one thread pool, see pool_t. Include world.h instead of tp-core.h and tp.h.
+ */
+
 /** @defgroup tp-types Types
  *
  * Customizable types and function specifiers.
@@ -62,10 +87,27 @@
  * independent storage implementations. From the application memory can be accessed
  * uniformly through the Memory Access Functions.
  *
- * A default memory allocation, and an allocation suitable for running the engine as a
- * CUDA kernel are provided. The macro #TP_MEM, is used for selecting the memory allocation, and
+ * A default memory allocation, an allocation suitable for running the engine as a
+ * CUDA kernel and an allocation interleaving blocks of worlds, memory/interleaved.h, are provided. The macro #TP_MEM, is used for selecting the memory allocation, and
  * may link to a user-defined header. A memory implementation needs to provide a definition of
  * the struct mem_t type, in addition to implement all the Memory Access Implementation Unique Functions.
+ *
+ * With memory/interleaved.h a struct mem_t is a handle to one world (lane) of a struct mem_block_t,
+ * which holds #TP_LANES worlds. The handles of a block are set up by init_mem_block(). Since the
+ * components of vectors and matrices are not adjacent in this layout, memory must only be accessed
+ * through the memory access functions. All worlds of a block are stepped at once, one world per
+ * SIMD lane, by step_block().
+ *
+ * With memory/shared.h a struct mem_t holds the state of one world and points to a struct model_t,
+ * which holds the data that is the same for all worlds of a robot: masses, inertias, hinge geometry,
+ * the motor map and the hinge and motor force limits. The solver work memory is kept once per thread.
+ * The model is zeroed by zero_model() and configured through a first world, further worlds are
+ * created by copying the configured struct mem_t.
+ *
+ * With memory/dynamic.h, selected by #TP_DYNAMIC, the size of the model is a member of struct mem_t
+ * set by init_memory(), and the arrays point into one block of storage of size_memory() bytes.
+ * Models that are only known at runtime can then be stepped by the same build, and the storage of
+ * many worlds can be carved from a single allocation.
  */
 
 /** @defgroup tp-dev Development
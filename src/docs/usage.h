@@ -4,7 +4,7 @@
  * In order to use TEPE the simulation model must be defined at compile-
  * time. The definition of the following group of macros makes sure that enough
  * memory is allocated to hold the simulation model. These macros need to be defined
- * prior to the inclusion of tp.h.
+ * prior to the inclusion of tp.h, unless #TP_DYNAMIC is defined.
  *
  */
 //@{
@@ -84,16 +84,198 @@
  */
 #define TP_ERP
 
+/** \def TP_POST_STABILIZATION
+ *
+ * If defined, the drift of the hinges is not corrected by a velocity bias in the
+ * constraint solver, see compute_rhs(), but by moving the bodies after the
+ * integration, see project_positions(). The correction then adds no energy, and the
+ * hinges stay together far more tightly. #TP_ERP is the fraction of the error that
+ * is corrected. Not available with #TP_LANES.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_POST_STABILIZATION
+
+/** \def TP_PROJECTION_ITERATIONS
+ *
+ * Number of sweeps of project_positions() in every step, if #TP_POST_STABILIZATION
+ * is defined. Defaults to 4.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_PROJECTION_ITERATIONS
+
+/** \def TP_BLOCK_HINGES
+ *
+ * If defined, the constraint solver solves the five rows of each hinge together,
+ * by the inverse of their 5x5 block of \f$JB\f$, instead of one row at a time. Chains
+ * of bodies with very different masses then need far fewer iterations, see
+ * solve_for_lambda(). The lane-per-world kernel, step_block(), still solves one row
+ * at a time.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_BLOCK_HINGES
+
+/** \def TP_TREE_SOLVER
+ *
+ * If defined, the constraint solver solves all hinge rows exactly in every sweep,
+ * in time linear in the number of bodies, instead of one row at a time. The motor
+ * and contact rows, which have limits, are still solved by Projected Gauss-Seidel.
+ * The hinges must not form loops, in which case the rows are solved one at a time.
+ * Takes precedence over #TP_BLOCK_HINGES. See factor_tree() and solve_tree().
+ *
+ * @ingroup tp-usage
+ */
+#define TP_TREE_SOLVER
+
+/** \def TP_NNCG
+ *
+ * If defined, step_world() solves the constraint forces by Nonsmooth Nonlinear
+ * Conjugate Gradient, solve_for_lambda_nncg(), instead of by Projected Gauss-Seidel,
+ * solve_for_lambda(). Long chains with high mass ratios then need far fewer iterations
+ * for the same accuracy. Both solvers can also be called directly. The lane-per-world
+ * kernel, step_block(), and solve_for_lambda_parallel() still use Projected Gauss-Seidel.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_NNCG
+
+/** \def TP_MIXED_PRECISION
+ *
+ * If defined, step_world() solves the constraint forces by solve_for_lambda_mixed(),
+ * which runs the sweeps in @b float and refines the Lagrange multipliers in #real_t
+ * every #TP_MIXED_SWEEPS sweeps. Meant to be used with #TP_DEFAULT_DOUBLE, for close
+ * to double precision accuracy at the memory traffic of single precision. Set
+ * PRECISION to MIXED in the Makefile to build with both. Ignored if #TP_NNCG is defined.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_MIXED_PRECISION
+
+/** \def TP_MIXED_SWEEPS
+ *
+ * Defines the number of sweeps between two refinements of solve_for_lambda_mixed().
+ * Defaults to 8.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_MIXED_SWEEPS
+
+/** \def TP_SYMMETRIC_SWEEPS
+ *
+ * If defined, every second sweep of the constraint solver runs backwards over the
+ * rows, from the contact rows to the hinge rows, see sweep_rows(). Together with
+ * order_rows() the forces then travel both down to and up from the feet every
+ * two sweeps. A leg standing on the ground needs several times fewer sweeps to
+ * reach a tolerance of 1e-5.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_SYMMETRIC_SWEEPS
+
+/** \def TP_CONTACT_TANGENTS
+ *
+ * If defined, a foot in contact also gets two tangent rows, which keep its center
+ * of mass from sliding along the ground, see collide_foot_cylinder_tri(). Otherwise
+ * only the normal rows are allocated and solved.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_CONTACT_TANGENTS
+
+/** \def TP_GYROSCOPIC
+ *
+ * If defined, step_world() adds the gyroscopic torque \f$-\omega \times I\omega\f$ of
+ * every body, linearized for implicit integration, see add_gyroscopic_torque(). Fast
+ * spinning bodies then keep their angular momentum, and stay stable at large
+ * timesteps. Not available with #TP_LANES.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_GYROSCOPIC
+
+/** \def TP_EXP_MAP
+ *
+ * If defined, the rotations are integrated by the exponential map, as the exact
+ * rotation by the angular velocity over the timestep, instead of by the first order
+ * quaternion update, see integrate_quaternion_exp(). Fast spinning bodies then keep
+ * their rotation accurate at larger timesteps. Not available with #TP_LANES.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_EXP_MAP
+
+/** \def TP_COMPACT_JACOBIAN
+ *
+ * If defined, \f$J\f$ and \f$B\f$ store one 6-vector per row instead of two. Hinge
+ * and motor rows store the angular parts of both bodies, since their translational
+ * parts are constant, and contact rows the translational and angular parts of the
+ * foot. This halves the per world footprint of \f$J\f$ and \f$B\f$, and row_dot_a()
+ * and add_lambda() only touch the non-zero entries of the hinge and motor rows. The
+ * rows can then only be read through get_row_tJ() and get_row_tB(), and arbitrary
+ * Jacobians can not be stored. Not available for memory/interleaved.h.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_COMPACT_JACOBIAN
+
 /** \def TP_MEM
  *
  * Defines the memory header/implementation to be used. The default setting is
  * to use memory/simple.h. TEPE also provides memory/cudaopt.h, which is an optimized
- * allocation for running multiple instances of TEPE, each in its own GPU thread.
+ * allocation for running multiple instances of TEPE, each in its own GPU thread,
+ * memory/interleaved.h, which stores the same scalar of #TP_LANES worlds
+ * next to each other for stepping many worlds on a CPU, and memory/shared.h,
+ * where many worlds on a CPU share one copy of the model data.
  * See \ref tp-mem.
  *
  * @ingroup tp-usage
  */
 #define TP_MEM
+
+/** \def TP_DYNAMIC
+ *
+ * If defined, the number of bodies, hinges, motors and feet are set per world at
+ * runtime by init_memory(), and #TP_BODIES, #TP_HINGES, #TP_MOTORS and #TP_FEET
+ * must not be defined. The memory layout is then memory/dynamic.h, with the arrays
+ * of a world in one block of storage of size_memory() bytes. The local arrays of the
+ * solver are taken from scratch space in the same block, see push_scratch(). The loops
+ * of the solver read their bounds from the world instead of from constants, at a cost
+ * of a few percent of throughput, see bench/dynamic_bench.cpp. Not available with #TP_MEM, #TP_LANES, #TP_TREE_SOLVER,
+ * #TP_MIXED_PRECISION, world.h or the parallel solver of \ref tp-batch.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_DYNAMIC
+
+/** \def TP_LANES
+ *
+ * Defines the number of worlds in a block of the memory/interleaved.h layout.
+ * Defaults to the number of scalars that fit in a 64 byte cache line.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_LANES
+
+/** \def TP_THREADS
+ *
+ * Defines the number of threads in the default pool used by step_worlds(). The default
+ * setting, 0, uses one thread per online CPU core. See \ref tp-batch.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_THREADS
+
+/** \def TP_NO_DISPATCH
+ *
+ * If defined, step_block() is only compiled for the instruction set given by the
+ * compiler flags, instead of for AVX-512, AVX2 and the baseline with the version
+ * picked at load time. See #TP_FUNC_LANES.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_NO_DISPATCH
 //@}
 
 /**
@@ -114,12 +296,22 @@
 
 /** \def TP_CONTACT_CONSTRAINTS
  *
- * Number of constraints that are allocated for each possible contact point.
+ * Number of constraints that are allocated for each foot, the normal rows of
+ * the contact points followed by #TP_CONTACT_TANGENT_CONSTRAINTS tangent rows.
  *
  * @ingroup tp-usage
  */
 #define TP_CONTACT_CONSTRAINTS
 
+/** \def TP_CONTACT_TANGENT_CONSTRAINTS
+ *
+ * Number of tangent constraints of each foot, 2 if #TP_CONTACT_TANGENTS is defined
+ * and 0 otherwise.
+ *
+ * @ingroup tp-usage
+ */
+#define TP_CONTACT_TANGENT_CONSTRAINTS
+
 /** \def TP_HINGE_CONSTRAINTS
  *
  * Index+1 for the last hinge constraint.
@@ -136,6 +328,30 @@
  */
 #define TP_HINGE_MOTOR_CONSTRAINTS
 
+/** \def TP_RELAX_HINGE
+ *
+ * Index of the relaxation factor of the hinge rows, see relax().
+ *
+ * @ingroup tp-usage
+ */
+#define TP_RELAX_HINGE
+
+/** \def TP_RELAX_MOTOR
+ *
+ * Index of the relaxation factor of the motor rows, see relax().
+ *
+ * @ingroup tp-usage
+ */
+#define TP_RELAX_MOTOR
+
+/** \def TP_RELAX_CONTACT
+ *
+ * Index of the relaxation factor of the contact rows, see relax().
+ *
+ * @ingroup tp-usage
+ */
+#define TP_RELAX_CONTACT
+
 /** \def TP_REAL
  *
  * Macro to type cast a float to the configured precision.
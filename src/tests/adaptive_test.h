@@ -0,0 +1,165 @@
+/*
+ * adaptive_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class adaptive_test : public CxxTest::TestSuite
+{
+public:
+
+	/** Tests that a smooth step is taken in one substep, the same as step_world(),
+	 * see step_world_adaptive().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_smooth_step()
+	{
+		struct mem_t *adaptive = stage_memory(false);
+		struct mem_t *fixed = stage_memory(false);
+
+		setup_leg(adaptive, 1.0);
+		setup_leg(fixed, 1.0);
+
+		int substeps = 4;
+		for(int step = 0; step < 10; ++step)
+		{
+			add_foot_forces(adaptive, 0.05, 0.1);
+			add_foot_forces(fixed, 0.05, 0.1);
+
+			step_world_adaptive(adaptive, 0.01, 20, 1e-1, 8, &substeps);
+			TS_ASSERT_EQUALS(substeps, (step < 2) ? 2 >> step : 1);
+
+			if(step >= 2) step_world(fixed, 0.01, 20);
+			else for(int k = 0; k < (4 >> step); ++k)
+			{
+				if(k > 0) add_foot_forces(fixed, 0.05, 0.1);
+				step_world(fixed, 0.01/(4 >> step), 20);
+			}
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_EQUALS(_x(pos(adaptive, b)), _x(pos(fixed, b)));
+			TS_ASSERT_EQUALS(_z(pos(adaptive, b)), _z(pos(fixed, b)));
+			TS_ASSERT_EQUALS(_z(vel(adaptive, b)), _z(vel(fixed, b)));
+		}
+
+		free(adaptive);
+		free(fixed);
+	}
+
+	/** Tests that the steps after a motor kicks the leg into fast rotation are
+	 * subdivided, keeping the joint drift below the error bound where steps of the
+	 * same size drift far more, see step_world_adaptive().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_motor_kick()
+	{
+		struct mem_t *adaptive = stage_memory(false);
+		struct mem_t *fixed = stage_memory(false);
+
+		setup_leg(adaptive, 1.0);
+		setup_leg(fixed, 1.0);
+
+		const real_t max_error = 2e-3;
+		int substeps = 1, most_substeps = 1;
+		real_t adaptive_drift = 0.0, fixed_drift = 0.0;
+
+		for(int step = 0; step < 20; ++step)
+		{
+			if(step == 10)
+			{
+				*mds(adaptive, 0) = 10.0;
+				*mds(fixed, 0) = 10.0;
+			}
+
+			add_foot_forces(adaptive, 0.05, 0.1);
+			add_foot_forces(fixed, 0.05, 0.1);
+
+			step_world_adaptive(adaptive, 0.02, 20, max_error, 64, &substeps);
+			step_world(fixed, 0.02, 20);
+
+			// The leg falls freely until the kick
+			if(step < 10) TS_ASSERT_EQUALS(substeps, 1);
+
+			if(substeps > most_substeps) most_substeps = substeps;
+			if(joint_drift(adaptive) > adaptive_drift) adaptive_drift = joint_drift(adaptive);
+			if(joint_drift(fixed) > fixed_drift) fixed_drift = joint_drift(fixed);
+		}
+
+		TS_ASSERT(most_substeps > 1);
+		TS_ASSERT(adaptive_drift < max_error);
+		TS_ASSERT(fixed_drift > 2*adaptive_drift);
+
+		free(adaptive);
+		free(fixed);
+	}
+	/** Tests that a restarted step starts over from the state and the Lagrange
+	 * multipliers of the step, the same as starting with the final number of
+	 * substeps, see step_world_adaptive().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_restart()
+	{
+		struct mem_t *restarted = stage_memory(false);
+		struct mem_t *direct = stage_memory(false);
+
+		setup_leg(restarted, 1.0);
+		setup_leg(direct, 1.0);
+
+		for(int step = 0; step < 10; ++step)
+		{
+			add_foot_forces(restarted, 0.05, 0.1);
+			add_foot_forces(direct, 0.05, 0.1);
+
+			step_world(restarted, 0.02, 20);
+			step_world(direct, 0.02, 20);
+		}
+
+		*mds(restarted, 0) = 10.0;
+		*mds(direct, 0) = 10.0;
+
+		add_foot_forces(restarted, 0.05, 0.1);
+		add_foot_forces(direct, 0.05, 0.1);
+
+		// No error is accepted, the step is restarted with 2, 4 and 8 substeps
+		int restarted_substeps = 1, direct_substeps = 8;
+		step_world_adaptive(restarted, 0.02, 20, 0.0, 8, &restarted_substeps);
+		step_world_adaptive(direct, 0.02, 20, 0.0, 8, &direct_substeps);
+
+		TS_ASSERT_EQUALS(restarted_substeps, 8);
+		TS_ASSERT_EQUALS(direct_substeps, 8);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_EQUALS(_x(pos(restarted, b)), _x(pos(direct, b)));
+			TS_ASSERT_EQUALS(_z(pos(restarted, b)), _z(pos(direct, b)));
+			TS_ASSERT_EQUALS(_x(vel(restarted, b)), _x(vel(direct, b)));
+		}
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_EQUALS(_lambda(restarted, s), _lambda(direct, s));
+
+		free(restarted);
+		free(direct);
+	}
+};
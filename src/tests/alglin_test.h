@@ -329,6 +329,82 @@ public:
 		check_equal(m2, tm1);
 	}
 
+	/** Tests inverting a 5x5 matrix, and detecting a singular one.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_invert_mtx55()
+	{
+		Matrix<double, 5, 5> m = Matrix<double, 5, 5>::Random();
+		m = m * m.transpose() + Matrix<double, 5, 5>::Identity();
+
+		real_t tm[25], tmi[25];
+		for(int i = 0; i < 5; ++i)
+			for(int j = 0; j < 5; ++j)
+				tm[i*5+j] = m(i, j);
+
+		TS_ASSERT(invert_mtx55(tmi, tm));
+
+		Matrix<double, 5, 5> mi = m.inverse();
+		for(int i = 0; i < 5; ++i)
+			for(int j = 0; j < 5; ++j)
+				TS_ASSERT_DELTA(mi(i, j), tmi[i*5+j], 1e-5);
+
+		for(int j = 0; j < 5; ++j) tm[3*5+j] = tm[1*5+j];
+		TS_ASSERT(!invert_mtx55(tmi, tm));
+	}
+
+	/** Tests inverting a 3x3 matrix, and detecting a singular one.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_invert_mtx33()
+	{
+		Matrix3d m = Matrix3d::Random();
+		m = m * m.transpose() + Matrix3d::Identity();
+
+		tp_mtx33 tm, tmi;
+		copy_mtx(m, tm);
+
+		TS_ASSERT(invert_mtx33(tmi, tm));
+
+		Matrix3d mi = m.inverse();
+		for(int i = 0; i < 3; ++i)
+			for(int j = 0; j < 3; ++j)
+				TS_ASSERT_DELTA(mi(i, j), tmi[i*TP_SIZE_VEC3+j], 1e-5);
+
+		for(int j = 0; j < 3; ++j) tm[2*TP_SIZE_VEC3+j] = tm[0*TP_SIZE_VEC3+j];
+		TS_ASSERT(!invert_mtx33(tmi, tm));
+	}
+
+	/** Tests rotating a quaternion by the exponential map, for an angle on each
+	 * side of the Taylor series, see integrate_quaternion_exp().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_integrate_quaternion_exp()
+	{
+		for(int i = 0; i < 2; ++i)
+		{
+			Quaterniond q(AngleAxisd(0.7, Vector3d(1.0, 2.0, -0.5).normalized()));
+			Vector3d w = (i == 0) ? Vector3d(0.3, -0.1, 0.2) : Vector3d(30.0, -10.0, 20.0);
+			double dt = 0.02;
+
+			tp_quatern tq;
+			tp_vec3 tw;
+			copy_quaternion(q, tq);
+			copy_vec(w, tw);
+
+			integrate_quaternion_exp(tq, tw, dt);
+
+			Quaterniond r = Quaterniond(AngleAxisd(w.norm()*dt, w.normalized())) * q;
+			TS_ASSERT_DELTA(r.w(), tq[0], 1e-6);
+			TS_ASSERT_DELTA(r.x(), tq[1], 1e-6);
+			TS_ASSERT_DELTA(r.y(), tq[2], 1e-6);
+			TS_ASSERT_DELTA(r.z(), tq[3], 1e-6);
+		}
+	}
+
 	/** Tests computing the special quaternion, angular velocity product.
 	 *
 	 * @ingroup tp-tests
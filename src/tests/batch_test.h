@@ -0,0 +1,228 @@
+/*
+ * batch_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#define TP_THREADS	4
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+#include <tp/batch.h>
+
+#include "helpers.h"
+
+class batch_test : public CxxTest::TestSuite
+{
+public:
+
+	/** Tests that stepping a batch of worlds on a thread pool gives exactly
+	 * the same result as stepping the worlds one by one, see \ref tp-batch.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_worlds()
+	{
+		const size_t n = 37;
+
+		struct mem_t *batch = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+		struct mem_t *serial = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			zero_memory(batch + w);
+			setup_lying_chain(batch + w, 0.01*w);
+			zero_memory(serial + w);
+			setup_lying_chain(serial + w, 0.01*w);
+		}
+
+		for(int step = 0; step < 20; ++step)
+		{
+			for(size_t w = 0; w < n; ++w)
+			{
+				add_foot_forces(batch + w, 0.2, 0.3);
+				add_foot_forces(serial + w, 0.2, 0.3);
+			}
+
+			step_worlds(batch, n, 0.005, 20);
+
+			for(size_t w = 0; w < n; ++w)
+				step_world(serial + w, 0.005, 20);
+		}
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			for(int b = 0; b < TP_BODIES; ++b)
+			{
+				TS_ASSERT_EQUALS(_x(pos(batch + w, b)), _x(pos(serial + w, b)));
+				TS_ASSERT_EQUALS(_y(pos(batch + w, b)), _y(pos(serial + w, b)));
+				TS_ASSERT_EQUALS(_z(pos(batch + w, b)), _z(pos(serial + w, b)));
+
+				TS_ASSERT_EQUALS(_q0(quatern(batch + w, b)), _q0(quatern(serial + w, b)));
+				TS_ASSERT_EQUALS(_q1(quatern(batch + w, b)), _q1(quatern(serial + w, b)));
+				TS_ASSERT_EQUALS(_q2(quatern(batch + w, b)), _q2(quatern(serial + w, b)));
+				TS_ASSERT_EQUALS(_q3(quatern(batch + w, b)), _q3(quatern(serial + w, b)));
+			}
+		}
+
+		std::free(batch);
+		std::free(serial);
+	}
+
+	/** Tests that a colliding foot activates all of its contact rows once, also
+	 * if it collides again, and that stepping zeroes and deactivates them, see
+	 * activate_contact_row().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_active_contact_rows()
+	{
+		struct mem_t *grounded = stage_memory(false);
+		struct mem_t *airborne = stage_memory(false);
+
+		setup_lying_chain(grounded, 0.0);
+		setup_lying_chain(airborne, 1.0);
+
+		add_foot_forces(grounded, 0.2, 0.3);
+		add_foot_forces(airborne, 0.2, 0.3);
+
+		TS_ASSERT_EQUALS(_ncrows(airborne), 0);
+		TS_ASSERT_EQUALS(num_active_rows(airborne), TP_HINGE_MOTOR_CONSTRAINTS);
+
+		TS_ASSERT_EQUALS(_ncrows(grounded), TP_CONTACT_CONSTRAINTS);
+		for(int c = 0; c < TP_CONTACT_CONSTRAINTS; ++c)
+			TS_ASSERT_EQUALS(active_row(grounded, TP_HINGE_MOTOR_CONSTRAINTS + c), TP_HINGE_MOTOR_CONSTRAINTS + c);
+
+		collide_foot_cylinder_tri(grounded, 0.2, 0.3, 0, TP_BODIES-1);
+		TS_ASSERT_EQUALS(_ncrows(grounded), TP_CONTACT_CONSTRAINTS);
+
+		step_world(grounded, 0.005, 20);
+		step_world(airborne, 0.005, 20);
+
+		TS_ASSERT_EQUALS(_ncrows(grounded), 0);
+		TS_ASSERT_EQUALS(_ncrows(airborne), 0);
+
+		for(int s = TP_HINGE_MOTOR_CONSTRAINTS; s < TP_CONSTRAINTS; ++s)
+		{
+			TS_ASSERT_EQUALS(_z(tJ(grounded, s, 1)), 0.0);
+			TS_ASSERT_EQUALS(_x(aJ(grounded, s, 1)), 0.0);
+		}
+
+		free(grounded);
+		free(airborne);
+	}
+
+	/** Tests that hinges sharing a body get different colours, see colour_hinges().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_colour_hinges()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_lying_chain(m, 0.0);
+
+		struct colouring_t colouring;
+		colour_hinges(m, &colouring);
+
+		// Both hinges hold body 1
+		TS_ASSERT_EQUALS(colouring.num_colours, 2);
+		TS_ASSERT_EQUALS(colouring.colour_start[1] - colouring.colour_start[0], 1);
+
+		// The motor row follows the rows of its hinge
+		TS_ASSERT_EQUALS(colouring.unit_start[1], 6);
+		TS_ASSERT_EQUALS(colouring.rows[5], TP_HINGE_CONSTRAINTS);
+		TS_ASSERT_EQUALS(colouring.unit_start[2], TP_HINGE_MOTOR_CONSTRAINTS);
+
+		free(m);
+	}
+
+	/** Tests that the parallel solver gives the same result for any number of
+	 * threads, and a result close to the serial solver, see solve_for_lambda_parallel().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_world_parallel()
+	{
+		struct pool_t one, three;
+		init_pool(&one, 1);
+		init_pool(&three, 3);
+
+		struct mem_t *w1 = stage_memory(false);
+		struct mem_t *w3 = stage_memory(false);
+		struct mem_t *serial = stage_memory(false);
+		setup_lying_chain(w1, 0.0);
+		setup_lying_chain(w3, 0.0);
+		setup_lying_chain(serial, 0.0);
+
+		struct colouring_t colouring;
+		colour_hinges(w1, &colouring);
+
+		for(int step = 0; step < 20; ++step)
+		{
+			add_foot_forces(w1, 0.2, 0.3);
+			add_foot_forces(w3, 0.2, 0.3);
+			add_foot_forces(serial, 0.2, 0.3);
+
+			step_world_parallel(&one, w1, &colouring, 0.005, 100);
+			step_world_parallel(&three, w3, &colouring, 0.005, 100);
+			step_world(serial, 0.005, 100);
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_EQUALS(_x(pos(w1, b)), _x(pos(w3, b)));
+			TS_ASSERT_EQUALS(_y(pos(w1, b)), _y(pos(w3, b)));
+			TS_ASSERT_EQUALS(_z(pos(w1, b)), _z(pos(w3, b)));
+
+			TS_ASSERT_DELTA(_x(pos(w3, b)), _x(pos(serial, b)), 1e-4);
+			TS_ASSERT_DELTA(_y(pos(w3, b)), _y(pos(serial, b)), 1e-4);
+			TS_ASSERT_DELTA(_z(pos(w3, b)), _z(pos(serial, b)), 1e-4);
+		}
+
+		free(w1);
+		free(w3);
+		free(serial);
+
+		destroy_pool(&one);
+		destroy_pool(&three);
+	}
+
+	static void count_task(void *data, size_t begin, size_t end)
+	{
+		int *counts = (int *)data;
+		for(size_t i = begin; i < end; ++i) ++counts[i];
+	}
+
+	/** Tests that a pool runs every item of a job exactly once.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_run_pool()
+	{
+		struct pool_t pool;
+		init_pool(&pool, 3);
+
+		const size_t n = 1000;
+		int counts[n];
+		for(size_t i = 0; i < n; ++i) counts[i] = 0;
+
+		for(int job = 0; job < 10; ++job)
+			run_pool(&pool, count_task, (void *)counts, n, 7);
+
+		for(size_t i = 0; i < n; ++i)
+			TS_ASSERT_EQUALS(counts[i], 10);
+
+		destroy_pool(&pool);
+	}
+};
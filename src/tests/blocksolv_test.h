@@ -0,0 +1,123 @@
+/*
+ * blocksolv_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	2
+#define TP_HINGES	1
+#define TP_MOTORS	0
+#define TP_FEET 	0
+
+#define TP_ERP		0.0
+
+#define TP_BLOCK_HINGES
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+#include <Eigen/LU>
+
+class blocksolv_test : public CxxTest::TestSuite
+{
+public:
+
+	/** Tests that a single sweep of the block solver solves a random hinge
+	 * system, see solve_hinge_block().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_system_random()
+	{
+		struct mem_t *m = stage_memory();
+
+		real_t dt = 1.0;
+
+		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> rJ;
+		set_random_J(m, rJ);
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi = Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		set_random_Mi(m, rMi);
+
+		Matrix<real_t, 6*TP_BODIES, 1> rv;
+		set_random_v(m, rv);
+
+		Matrix<real_t, 6*TP_BODIES, 1> rFe;
+		set_random_Fe(m, rFe);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rrhs = -rJ * (1/dt * rv + rMi * rFe);
+		Matrix<real_t, TP_CONSTRAINTS, TP_CONSTRAINTS> A = rJ * rMi * rJ.transpose();
+
+		TS_ASSERT_EQUALS(solve_for_lambda(m, dt, 1), 1);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rlambda = A.partialPivLu().solve(rrhs);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(rlambda(s), _lambda(m, s), 1e-2);
+
+		free(m);
+	}
+
+	/** Tests that a single sweep removes the velocity error of a hinge between
+	 * a heavy and a light body, the pair of the hinge demo.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_stiff_pair()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		*y(pos(m, 0)) = -0.5;
+		*y(pos(m, 1)) = 0.5;
+		set_box_inertia(15.0, mi(m, 0), 0.5, 0.5, 1.5, Ibi(m, 0));
+		set_box_inertia(1.0, mi(m, 1), 0.5, 0.5, 0.5, Ibi(m, 1));
+
+		tp_vec3 anchor = {0.0, 0.0, 0.0};
+		tp_vec3 axis = {1.0, 0.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor, axis);
+
+		update_kinematics(m);
+
+		Matrix<real_t, 6*TP_BODIES, 1> rv;
+		set_random_v(m, rv);
+
+		*z(tFe(m, 0)) = -9.81*15.0;
+		*z(tFe(m, 1)) = -9.81;
+
+		// The block sweep of solve_for_lambda(), also if step_world() selects another solver
+		update_jacobian(m);
+		solve_for_lambda(m, 0.005, 1);
+		integrate_world(m, 0.005);
+
+		for(int s = 0; s < TP_HINGE_CONSTRAINTS; ++s)
+		{
+			real_t Jv = TP_REAL(0.0);
+			for(int bi = 0; bi < 2; ++bi)
+			{
+				index_t body = _Jm(m, s, bi);
+
+				tp_vec3 _tJ, _aJ, _vel, _omega;
+				get_row_tJ(m, s, bi, _tJ);
+				get_vec3(aJ(m, s, bi), _aJ);
+				get_vec3(vel(m, body), _vel);
+				get_vec3(omega(m, body), _omega);
+
+				Jv += dot_vec3(_tJ, _vel) + dot_vec3(_aJ, _omega);
+			}
+
+			TS_ASSERT_DELTA(Jv, 0.0, 1e-4);
+		}
+
+		free(m);
+	}
+};
+
@@ -0,0 +1,163 @@
+/*
+ * compactj_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	4
+#define TP_HINGES	3
+#define TP_MOTORS	1
+#define TP_FEET 	0
+
+#define TP_ERP		0.0
+
+#ifndef TP_COMPACT_JACOBIAN
+#define TP_COMPACT_JACOBIAN
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+#include <Eigen/LU>
+
+class compactj_test : public CxxTest::TestSuite
+{
+public:
+
+	void setup_world(struct mem_t *m)
+	{
+		// A body with two children, one of which has a child
+		real_t masses[TP_BODIES] = {10.0, 1.0, 2.0, 0.5};
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = (b == 3) ? 2.0 : (b == 0) ? 0.0 : 1.0;
+			*y(pos(m, b)) = (b == 2) ? 1.0 : 0.0;
+			set_box_inertia(masses[b], mi(m, b), 0.5, 0.3, 0.2, Ibi(m, b));
+		}
+
+		tp_vec3 axis0 = {0.0, 1.0, 0.0}, anchor0 = {0.5, 0.0, 0.0};
+		tp_vec3 axis1 = {1.0, 0.0, 0.0}, anchor1 = {0.5, 0.5, 0.0};
+		tp_vec3 axis2 = {0.0, 0.0, 1.0}, anchor2 = {1.5, 0.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor0, axis0);
+		create_hinge(m, 1, 2, 0, anchor1, axis1);
+		create_hinge(m, 2, 1, 3, anchor2, axis2);
+
+		add_motor(m, 0, 2, 1e6);
+		*mds(m, 0) = 0.5;
+
+		update_kinematics(m);
+		update_jacobian(m);
+	}
+
+	/** Tests that the compact Jacobian holds one 6-vector per row, and that the
+	 * constant translational parts of the hinge and motor rows are constructed,
+	 * see get_row_tJ() and get_row_tB().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_compact_rows()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_world(m);
+
+		TS_ASSERT_EQUALS(sizeof(m->J), TP_SIZE_VEC6*TP_CONSTRAINTS*sizeof(real_t));
+		TS_ASSERT_EQUALS(sizeof(m->B), TP_SIZE_VEC6*TP_CONSTRAINTS*sizeof(real_t));
+
+		compute_B(m);
+
+		for(int s = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s)
+		{
+			for(int bi = 0; bi < 2; ++bi)
+			{
+				tp_vec3 _tJ, _tB;
+				get_row_tJ(m, s, bi, _tJ);
+				get_row_tB(m, s, bi, _tB);
+
+				for(int k = 0; k < 3; ++k)
+				{
+					real_t e = (s < TP_HINGE_CONSTRAINTS && s % 5 == k) ? ((bi == 0) ? 1.0 : -1.0) : 0.0;
+
+					TS_ASSERT_EQUALS(_tJ[k], e);
+					TS_ASSERT_DELTA(_tB[k], e * _mi(m, _Jm(m, s, bi)), 1e-6);
+				}
+			}
+		}
+
+		// The angular parts of the two bodies do not overlap
+		TS_ASSERT_EQUALS(aJ(m, 0, 1) - aJ(m, 0, 0), 3);
+		TS_ASSERT_EQUALS(aJ(m, 1, 0) - aJ(m, 0, 0), TP_SIZE_VEC6);
+
+		free(m);
+	}
+
+	/** Tests that the specialised row kernels of the compact Jacobian converge to
+	 * the exact solution of the hinge and motor rows, see row_dot_a() and add_lambda().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_compact()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_world(m);
+
+		real_t dt = 1.0;
+
+		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> rJ = Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES>::Zero();
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+		{
+			for(int bi = 0; bi < 2; ++bi)
+			{
+				index_t body = _Jm(m, s, bi);
+
+				tp_vec3 _tJ;
+				get_row_tJ(m, s, bi, _tJ);
+
+				for(int k = 0; k < 3; ++k)
+				{
+					rJ(s, body*6+k) = _tJ[k];
+					rJ(s, body*6+3+k) = aJ(m, s, bi)[k];
+				}
+			}
+		}
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi = Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			for(int k = 0; k < 3; ++k)
+				rMi(b*6+k, b*6+k) = _mi(m, b);
+
+			for(int r = 0; r < 3; ++r)
+				for(int c = 0; c < 3; ++c)
+					rMi(b*6+3+r, b*6+3+c) = _ij(Iwi(m, b), r, c);
+		}
+
+		Matrix<real_t, 6*TP_BODIES, 1> rv;
+		set_random_v(m, rv);
+
+		Matrix<real_t, 6*TP_BODIES, 1> rFe;
+		set_random_Fe(m, rFe);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rrhs = -rJ * (1/dt * rv + rMi * rFe);
+		rrhs(TP_HINGE_CONSTRAINTS) += _mds(m, 0)/dt;
+
+		Matrix<real_t, TP_CONSTRAINTS, TP_CONSTRAINTS> A = rJ * rMi * rJ.transpose();
+
+		solve_for_lambda(m, dt, 5000);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rlambda = A.partialPivLu().solve(rrhs);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(rlambda(s), _lambda(m, s), 1e-2);
+
+		free(m);
+	}
+};
@@ -181,4 +181,172 @@ public:
 
 		free(m);
 	}
+
+	/** Tests the kinematics cache, see update_kinematics().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_update_kinematics()
+	{
+		struct mem_t *m = stage_memory();
+
+		Matrix<real_t, 3, 3> rR[TP_BODIES];
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			Matrix<real_t, 4, 1> rq = Matrix<real_t, 4, 1>::Random();
+			rq.normalize();
+
+			tp_quatern _quatern = {rq(0), rq(1), rq(2), rq(3)};
+			set_quatern(_quatern, quatern(m, b));
+
+			tp_mtx33 _R;
+			quaternion_to_rot_mtx33(_quatern, _R);
+			set_mtx33(_R, R(m, b));
+
+			for(int row = 0; row < 3; ++row)
+				for(int col = 0; col < 3; ++col)
+					rR[b](row, col) = _R[row*TP_SIZE_VEC3 + col];
+
+			*x(pos(m, b)) = b;
+		}
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi = Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		set_random_Mi(m, rMi);
+
+		tp_vec3 anchor = {0.5, 0.2, 0.1};
+		tp_vec3 axis = {0.3, 1.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor, axis);
+
+		update_kinematics(m);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			Matrix<real_t, 3, 3> rIwi = rR[b] * rMi.block<3, 3>(6*b+3, 6*b+3) * rR[b].transpose();
+
+			for(int row = 0; row < 3; ++row)
+				for(int col = 0; col < 3; ++col)
+					TS_ASSERT_DELTA(_ij(Iwi(m, b), row, col), rIwi(row, col), 1e-5);
+		}
+
+		for(int i = 0; i < 2; ++i)
+		{
+			index_t b = _Jm(m, 0, i);
+
+			// The anchor is the same point seen from both bodies, and the axis the same direction
+			TS_ASSERT_DELTA(_x(pos(m, b)) + _x(hanchor_world(m, 0, i)), anchor[0], 1e-5);
+			TS_ASSERT_DELTA(_y(pos(m, b)) + _y(hanchor_world(m, 0, i)), anchor[1], 1e-5);
+			TS_ASSERT_DELTA(_z(pos(m, b)) + _z(hanchor_world(m, 0, i)), anchor[2], 1e-5);
+
+			normalize_vec3(axis);
+			TS_ASSERT_DELTA(_x(haxis_world(m, 0, i)), axis[0], 1e-5);
+			TS_ASSERT_DELTA(_y(haxis_world(m, 0, i)), axis[1], 1e-5);
+			TS_ASSERT_DELTA(_z(haxis_world(m, 0, i)), axis[2], 1e-5);
+		}
+
+		free(m);
+	}
+
+	/** Tests that the velocity update applies the constraint forces through
+	 * \f$a\f$, see integrate_world().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_integrate_world()
+	{
+		struct mem_t *m = stage_memory();
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi	= Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> rJ	= Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES>::Zero();
+
+		Matrix<real_t, 6*TP_BODIES, 1> rFe 	= Matrix<real_t, 6*TP_BODIES, 1>::Zero();
+		Matrix<real_t, 6*TP_BODIES, 1> rv 	= Matrix<real_t, 6*TP_BODIES, 1>::Zero();
+
+		set_random_J(m, rJ);
+		set_random_Mi(m, rMi);
+		set_random_Fe(m, rFe);
+		set_random_v(m, rv);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rlambda;
+		set_random_lambda(m, rlambda);
+
+		compute_B(m);
+		compute_a(m);
+
+		real_t dt = 0.01;
+		Matrix<real_t, 6*TP_BODIES, 1> rv_next = rv + dt * rMi * (rFe + rJ.transpose() * rlambda);
+		integrate_world(m, dt);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_DELTA(_x(vel(m, b)), rv_next(b*6), 1e-5);
+			TS_ASSERT_DELTA(_y(vel(m, b)), rv_next(b*6+1), 1e-5);
+			TS_ASSERT_DELTA(_z(vel(m, b)), rv_next(b*6+2), 1e-5);
+
+			TS_ASSERT_DELTA(_x(omega(m, b)), rv_next(b*6+3), 1e-5);
+			TS_ASSERT_DELTA(_y(omega(m, b)), rv_next(b*6+4), 1e-5);
+			TS_ASSERT_DELTA(_z(omega(m, b)), rv_next(b*6+5), 1e-5);
+
+			// The forces are cleared for the next step
+			TS_ASSERT_EQUALS(_x(tFe(m, b)), 0.0);
+			TS_ASSERT_EQUALS(_z(aFe(m, b)), 0.0);
+		}
+
+		TS_ASSERT_EQUALS(_ncrows(m), 0);
+
+		free(m);
+	}
+
+	/** Tests that the fused setup pass gives the same \f$B\f$, \f$a\f$, \f$d\f$
+	 * and \f$rhs\f$ as the separate functions, see setup_rows().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_setup_rows()
+	{
+		struct mem_t *m = stage_memory();
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi	= Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> rJ	= Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES>::Zero();
+
+		Matrix<real_t, 6*TP_BODIES, 1> rFe 	= Matrix<real_t, 6*TP_BODIES, 1>::Zero();
+		Matrix<real_t, 6*TP_BODIES, 1> rv 	= Matrix<real_t, 6*TP_BODIES, 1>::Zero();
+
+		set_random_J(m, rJ);
+		set_random_Mi(m, rMi);
+		set_random_Fe(m, rFe);
+		set_random_v(m, rv);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rlambda;
+		set_random_lambda(m, rlambda);
+
+		real_t dt = 0.01;
+
+		Matrix<real_t, 6*TP_BODIES, TP_CONSTRAINTS> rB = rMi * (rJ.transpose());
+		Matrix<real_t, 6*TP_BODIES, 1> ra = rB * rlambda;
+		Matrix<real_t, TP_CONSTRAINTS, 1> rd = (rJ * rB).diagonal();
+		Matrix<real_t, TP_CONSTRAINTS, 1> rrhs = - rJ * (1/dt * rv + rMi * rFe);
+
+		setup_rows(m, dt);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+		{
+			TS_ASSERT_DELTA(_d(m, s), rd(s), 1e-5);
+			TS_ASSERT_DELTA(_di(m, s)*_d(m, s), 1.0, 1e-5);
+			TS_ASSERT_DELTA(_rhs(m, s), rrhs(s), 1e-3);
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_DELTA(_x(ta(m, b)), ra(b*6), 1e-5);
+			TS_ASSERT_DELTA(_y(ta(m, b)), ra(b*6+1), 1e-5);
+			TS_ASSERT_DELTA(_z(ta(m, b)), ra(b*6+2), 1e-5);
+
+			TS_ASSERT_DELTA(_x(aa(m, b)), ra(b*6+3), 1e-5);
+			TS_ASSERT_DELTA(_y(aa(m, b)), ra(b*6+4), 1e-5);
+			TS_ASSERT_DELTA(_z(aa(m, b)), ra(b*6+5), 1e-5);
+		}
+
+		free(m);
+	}
 };
@@ -75,5 +75,89 @@ public:
 
 		free(m);
 	}
+
+	void setup_motor_world(struct mem_t *m)
+	{
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = b;
+			set_box_inertia(TP_REAL(1.0 + b), mi(m, b), 0.5, 0.5, 0.5, Ibi(m, b));
+		}
+
+		tp_vec3 axis = {0.0, 1.0, 0.0};
+		tp_vec3 anchor = {0.5, 0.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor, axis);
+
+		add_motor(m, 0, 0, 10.0);
+		*mds(m, 0) = 0.5;
+
+		update_kinematics(m);
+	}
+
+	/** Tests that the constraint solver stops when the change in the Lagrange
+	 * multipliers is below the tolerance, and that the solution is close to
+	 * the one given by running all iterations, see solve_for_lambda().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_tolerance()
+	{
+		struct mem_t *full = stage_memory(false);
+		struct mem_t *early = stage_memory(false);
+
+		setup_motor_world(full);
+		setup_motor_world(early);
+
+		const int max_iterations = 200;
+
+		for(int step = 0; step < 10; ++step)
+		{
+			TS_ASSERT_EQUALS(step_world(full, 0.005, max_iterations), max_iterations);
+
+			int iterations = step_world(early, 0.005, max_iterations, 1e-4);
+			TS_ASSERT_LESS_THAN(iterations, max_iterations);
+			TS_ASSERT_LESS_THAN(0, iterations);
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_DELTA(_x(omega(early, b)), _x(omega(full, b)), 1e-3);
+			TS_ASSERT_DELTA(_y(omega(early, b)), _y(omega(full, b)), 1e-3);
+			TS_ASSERT_DELTA(_z(omega(early, b)), _z(omega(full, b)), 1e-3);
+		}
+
+		free(full);
+		free(early);
+	}
+
+	/** Tests that over-relaxed sweeps converge to the same Lagrange multipliers as
+	 * Projected Gauss-Seidel, in fewer iterations, see relax().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_relaxed()
+	{
+		struct mem_t *pgs = stage_memory(false);
+		struct mem_t *sor = stage_memory(false);
+
+		setup_motor_world(pgs);
+		setup_motor_world(sor);
+
+		*relax(sor, TP_RELAX_HINGE) = 1.1;
+
+		update_jacobian(pgs);
+		update_jacobian(sor);
+
+		int pgs_iterations = solve_for_lambda(pgs, 0.005, 1000, 1e-6);
+		int sor_iterations = solve_for_lambda(sor, 0.005, 1000, 1e-6);
+
+		TS_ASSERT_LESS_THAN(sor_iterations, pgs_iterations);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(_lambda(sor, s), _lambda(pgs, s), 1e-3);
+
+		free(pgs);
+		free(sor);
+	}
 };
 
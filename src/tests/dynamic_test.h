@@ -0,0 +1,119 @@
+/*
+ * dynamic_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_DYNAMIC
+
+#include <tp/tp-core.h>
+#include <tp/tp.h>
+
+#include <cstdlib>
+
+#include "helpers.h"
+
+class dynamic_test : public CxxTest::TestSuite
+{
+public:
+
+	/** Tests that worlds of two model sizes, set at runtime, are carved from one
+	 * allocation and stepped side by side without touching each other's storage,
+	 * see init_memory().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_runtime_sizes()
+	{
+		size_t size3 = size_memory(3, 2, 1, 1);
+		size_t size5 = size_memory(5, 4, 2, 2);
+
+		TS_ASSERT_EQUALS(size3 % 64, 0u);
+		TS_ASSERT(size3 < size5);
+
+		char *storage = (char *)std::aligned_alloc(64, size3 + size5 + 64);
+		storage[size3 + size5] = 42;
+
+		struct mem_t worlds[2];
+		init_memory(worlds + 0, storage, 3, 2, 1, 1);
+		init_memory(worlds + 1, storage + size3, 5, 4, 2, 2);
+
+		struct mem_t *m = worlds + 1;
+		TS_ASSERT_EQUALS(TP_CONSTRAINTS, 5*4 + 2 + 2*TP_CONTACT_CONSTRAINTS);
+		TS_ASSERT_EQUALS(_rorder(m, TP_HINGE_MOTOR_CONSTRAINTS - 1), TP_HINGE_MOTOR_CONSTRAINTS - 1);
+
+		setup_lying_chain(worlds + 0, 0.0);
+		setup_lying_chain(worlds + 1, 0.0);
+
+		for(int step = 0; step < 20; ++step)
+		{
+			add_foot_forces(worlds + 1, 0.2, 0.3);
+			step_world(worlds + 1, 0.005, 20);
+		}
+
+		// The small world is untouched by stepping the large one
+		m = worlds + 0;
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_EQUALS(_x(pos(m, b)), b);
+			TS_ASSERT_EQUALS(_z(pos(m, b)), TP_REAL(0.1));
+		}
+		TS_ASSERT_EQUALS(storage[size3 + size5], 42);
+
+		// The large chain falls and stays together
+		m = worlds + 1;
+		TS_ASSERT(_z(pos(m, 0)) < 0.1);
+		TS_ASSERT_DELTA(_x(pos(m, 4)) - _x(pos(m, 0)), 4.0, 1e-2);
+
+		for(int step = 0; step < 20; ++step)
+		{
+			add_foot_forces(worlds + 0, 0.2, 0.3);
+			step_world(worlds + 0, 0.005, 20);
+		}
+
+		m = worlds + 0;
+		TS_ASSERT(_z(pos(m, 0)) < 0.1);
+		TS_ASSERT_DELTA(_x(pos(m, 2)) - _x(pos(m, 0)), 2.0, 1e-2);
+
+		std::free(storage);
+	}
+
+	/** Tests that the local arrays of order_rows() and step_world_adaptive() are
+	 * taken from the scratch space of the world, and all released on return, see
+	 * push_scratch().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_scratch()
+	{
+		char *storage = (char *)std::aligned_alloc(64, size_memory(5, 4, 2, 2));
+
+		struct mem_t world, *m = &world;
+		init_memory(m, storage, 5, 4, 2, 2);
+		setup_lying_chain(m, 0.05);
+
+		// Rooted at the first body, the last hinge is the deepest
+		index_t root = 0;
+		order_rows(m, &root, 1);
+		TS_ASSERT_EQUALS(m->scratch_used, 0u);
+		TS_ASSERT_EQUALS(_rorder(m, 0), 5*(TP_HINGES-1));
+
+		int substeps = 1;
+		for(int step = 0; step < 20; ++step)
+		{
+			add_foot_forces(m, 0.2, 0.3);
+			step_world_adaptive(m, 0.02, 20, 1e-3, 8, &substeps);
+			TS_ASSERT_EQUALS(m->scratch_used, 0u);
+		}
+
+		TS_ASSERT(_z(pos(m, 0)) < 0.15);
+		TS_ASSERT(joint_drift(m) < 1e-2);
+
+		std::free(storage);
+	}
+};
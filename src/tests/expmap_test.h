@@ -0,0 +1,113 @@
+/*
+ * expmap_test.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Body 2 is not connected, and spins freely
+#define TP_BODIES	3
+#define TP_HINGES	1
+#define TP_MOTORS	0
+#define TP_FEET 	0
+
+#ifndef TP_EXP_MAP
+#define TP_EXP_MAP
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+#include <cmath>
+
+class expmap_test : public CxxTest::TestSuite
+{
+public:
+
+	// All bodies spin about z, a principal axis, the hinged pair about the hinge
+	void setup_world(struct mem_t *m, real_t spin)
+	{
+		tp_vec3 first = {0.0, 0.0, 0.0}, spacing = {2.0, 0.0, 0.0};
+		tp_vec3 axis = {0.0, 0.0, 1.0}, size = {1.0, 0.5, 0.2};
+		setup_chain(m, first, spacing, axis, 0.0, size, 0.0, 0.0);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+			*z(omega(m, b)) = spin;
+
+		// The pair spins about their common z axis, through the hinge
+		*y(vel(m, 0)) = -spin;
+		*y(vel(m, 1)) = spin;
+	}
+
+	real_t dot(const tp_quatern a, const tp_quatern b)
+	{
+		return a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+	}
+
+	/** Tests that step_world() rotates a fast spinning free body by the exact angle
+	 * of each step, and keeps its quaternion of unit length, at a timestep where
+	 * the first order update lags by several degrees per second, see
+	 * integrate_quaternion_exp().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_free_body_angle()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		const real_t spin = 20.0, dt = 0.02;
+		setup_world(m, spin);
+
+		const int num_steps = 100;
+		for(int step = 0; step < num_steps; ++step)
+			step_world(m, dt, 20);
+
+		real_t half_angle = TP_REAL(0.5)*spin*dt*num_steps;
+
+		tp_quatern _quatern;
+		get_quatern(quatern(m, 2), _quatern);
+
+		TS_ASSERT_DELTA(_quatern[0], cos(half_angle), 1e-3);
+		TS_ASSERT_DELTA(_quatern[1], 0.0, 1e-5);
+		TS_ASSERT_DELTA(_quatern[2], 0.0, 1e-5);
+		TS_ASSERT_DELTA(_quatern[3], sin(half_angle), 1e-3);
+		TS_ASSERT_DELTA(dot(_quatern, _quatern), 1.0, 1e-5);
+
+		TS_ASSERT_DELTA(_z(omega(m, 2)), spin, 1e-3);
+
+		free(m);
+	}
+
+	/** Tests that the hinged pair, spinning together about the hinge, turns as
+	 * the free body does, see integrate_world().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_hinged_pair()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		setup_world(m, 1.0);
+
+		for(int step = 0; step < 200; ++step)
+			step_world(m, 0.02, 20);
+
+		for(int b = 0; b < 2; ++b)
+		{
+			tp_quatern q_pair, q_free;
+			get_quatern(quatern(m, b), q_pair);
+			get_quatern(quatern(m, 2), q_free);
+
+			TS_ASSERT_DELTA(fabs(dot(q_pair, q_free)), 1.0, 1e-3);
+		}
+
+		free(m);
+	}
+};
@@ -0,0 +1,132 @@
+/*
+ * gyro_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Body 2 is not connected, and spins freely
+#define TP_BODIES	3
+#define TP_HINGES	1
+#define TP_MOTORS	0
+#define TP_FEET 	0
+
+#ifndef TP_GYROSCOPIC
+#define TP_GYROSCOPIC
+#endif
+
+// The momentum lost without the torque is that of the first order rotation update
+#undef TP_EXP_MAP
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class gyro_test : public CxxTest::TestSuite
+{
+public:
+
+	void setup_world(struct mem_t *m, const tp_vec3 spin)
+	{
+		tp_vec3 first = {0.0, 0.0, 0.0}, spacing = {1.0, 0.0, 0.0};
+		tp_vec3 axis = {0.0, 0.0, 1.0}, size = {1.0, 0.5, 0.2};
+		setup_chain(m, first, spacing, axis, 0.0, size, 0.0, 0.0);
+
+		set_vec3(spin, omega(m, 2));
+	}
+
+	// Angular momentum and rotational energy of the free body
+	real_t momentum(struct mem_t *m, tp_vec3 L)
+	{
+		tp_mtx33 _Iwi, Iw;
+		get_mtx33(Iwi(m, 2), _Iwi);
+		invert_mtx33(Iw, _Iwi);
+
+		tp_vec3 _omega;
+		get_vec3(omega(m, 2), _omega);
+		mult_mtx33_vec3(L, Iw, _omega);
+
+		return TP_REAL(0.5)*dot_vec3(_omega, L);
+	}
+
+	// Steps a world as step_world(), without the gyroscopic torque
+	void step_world_plain(struct mem_t *m, real_t dt, int num_iterations)
+	{
+		update_jacobian(m);
+		solve_for_lambda(m, dt, num_iterations);
+		integrate_world(m, dt);
+	}
+
+	/** Tests that the implicit gyroscopic torque keeps the angular momentum of a
+	 * free body spinning about a tilted axis at a large timestep, which is lost
+	 * without it, see add_gyroscopic_torque().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_free_body_momentum()
+	{
+		struct mem_t *gyro = stage_memory(false);
+		struct mem_t *plain = stage_memory(false);
+
+		tp_vec3 spin = {0.5, 0.5, 20.0};
+		setup_world(gyro, spin);
+		setup_world(plain, spin);
+
+		tp_vec3 L0;
+		real_t E0 = momentum(gyro, L0);
+
+		for(int step = 0; step < 500; ++step)
+		{
+			step_world(gyro, 0.02, 20);
+			step_world_plain(plain, 0.02, 20);
+		}
+
+		tp_vec3 L, dL;
+
+		real_t E = momentum(gyro, L);
+		add_vec3(dL, L, L0, -1.0);
+		TS_ASSERT(norm2_vec3(dL) < 1e-2*norm2_vec3(L0));
+		TS_ASSERT(E <= E0*TP_REAL(1.0001));
+		TS_ASSERT(E > E0*TP_REAL(0.99));
+
+		momentum(plain, L);
+		add_vec3(dL, L, L0, -1.0);
+		TS_ASSERT(norm2_vec3(dL) > 2e-2*norm2_vec3(L0));
+
+		free(gyro);
+		free(plain);
+	}
+
+	/** Tests that a body tumbling about its intermediate axis does not gain energy
+	 * at a large timestep, see add_gyroscopic_torque().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_tumbling_body()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		tp_vec3 spin = {0.1, 20.0, 0.1};
+		setup_world(m, spin);
+
+		tp_vec3 L;
+		real_t E0 = momentum(m, L);
+
+		for(int step = 0; step < 1000; ++step)
+		{
+			step_world(m, 0.02, 20);
+
+			real_t E = momentum(m, L);
+			TS_ASSERT(E <= E0*TP_REAL(1.0001));
+			if(!(E <= E0*TP_REAL(1.0001))) break;
+		}
+
+		free(m);
+	}
+};
@@ -8,6 +8,93 @@
 #pragma once
 
 #include <cmath>
+
+
+// A chain of bodies, the first at first and each next one spacing further, hinged
+// about axis midway between them, with the last body as foot. Body b has mass
+// 1 + mass_step*b and the inertia of a box of side lengths size, motor i drives
+// hinge i at speed. A reversed hinge has the later body first.
+inline void setup_chain(
+		struct mem_t *m,
+		const tp_vec3 first,
+		const tp_vec3 spacing,
+		tp_vec3 axis,
+		real_t mass_step,
+		const tp_vec3 size,
+		real_t max_torque,
+		real_t speed,
+		bool reversed = false)
+{
+	tp_quatern eq = {1.0, 0.0, 0.0, 0.0};
+	tp_mtx33 eR;
+	quaternion_to_rot_mtx33(eq, eR);
+
+	for(int b = 0; b < TP_BODIES; ++b)
+	{
+		set_quatern(eq, quatern(m, b));
+		set_mtx33(eR, R(m, b));
+
+		*x(pos(m, b)) = first[0] + b*spacing[0];
+		*y(pos(m, b)) = first[1] + b*spacing[1];
+		*z(pos(m, b)) = first[2] + b*spacing[2];
+
+		set_box_inertia(1 + mass_step*b, mi(m, b), size[0], size[1], size[2], Ibi(m, b));
+	}
+
+	for(int h = 0; h < TP_HINGES; ++h)
+	{
+		tp_vec3 anchor;
+		for(int k = 0; k < 3; ++k)
+			anchor[k] = first[k] + (h + TP_REAL(0.5))*spacing[k];
+
+		if(reversed)
+			create_hinge(m, h, h+1, h, anchor, axis);
+		else
+			create_hinge(m, h, h, h+1, anchor, axis);
+	}
+
+	for(int i = 0; i < TP_MOTORS; ++i)
+	{
+		add_motor(m, i, i, max_torque);
+		*mds(m, i) = speed;
+	}
+
+	update_kinematics(m);
+}
+
+
+// A leg of bodies stacked along z, the lowest at height and the foot, with a
+// motor at the top hinge
+inline void setup_leg(struct mem_t *m, real_t height, real_t speed = 0)
+{
+	tp_vec3 top = {0.0, 0.0, height + TP_REAL(0.2)*(TP_BODIES-1)}, spacing = {0.0, 0.0, -0.2};
+	tp_vec3 axis = {0.0, 1.0, 0.0}, size = {0.1, 0.1, 0.1};
+	setup_chain(m, top, spacing, axis, 4.0, size, 10.0, speed);
+}
+
+
+// A chain of bodies along x, offset above the ground, with motors at the first hinges
+inline void setup_lying_chain(struct mem_t *m, real_t offset, bool reversed = false)
+{
+	tp_vec3 first = {0.0, 0.0, TP_REAL(0.1) + offset}, spacing = {1.0, 0.0, 0.0};
+	tp_vec3 axis = {0.0, 1.0, 0.0}, size = {0.5, 0.5, 0.5};
+	setup_chain(m, first, spacing, axis, 1.0, size, 1.0, 0.5, reversed);
+}
+
+
+// Collides the last body of a chain, as a foot cylinder, and adds gravity
+inline void add_foot_forces(struct mem_t *m, real_t radius, real_t height)
+{
+	collide_foot_cylinder_tri(m, radius, height, 0, TP_BODIES-1);
+
+	for(int b = 0; b < TP_BODIES; ++b)
+		*z(tFe(m, b)) += -9.81/_mi(m, b);
+}
+
+
+// The random matrices and worlds below are sized at compile time
+#ifndef TP_DYNAMIC
+
 #include <Eigen/Dense>
 #include <Eigen/Geometry>
 
@@ -35,6 +122,21 @@ inline struct mem_t * stage_memory(bool check_consistency = true)
 }
 
 
+// Stores the translational part of a random hinge or motor row, which is constant with TP_COMPACT_JACOBIAN
+template<typename Block>
+inline void set_random_row_tJ(struct mem_t *m, index_t s, index_t bi, Block rtJ)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	tp_vec3 _tJ;
+	get_row_tJ(m, s, bi, _tJ);
+	for(int k = 0; k < 3; ++k) rtJ(0, k) = _tJ[k];
+#else
+	*x(tJ(m, s, bi)) = rtJ(0, 0);
+	*y(tJ(m, s, bi)) = rtJ(0, 1);
+	*z(tJ(m, s, bi)) = rtJ(0, 2);
+#endif
+}
+
 inline void set_random_J(
 		struct mem_t *m,
 		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> &rJ)
@@ -48,9 +150,7 @@ inline void set_random_J(
 		rJ.block(s, ri*6, 1, 6).setRandom();
 
 		*Jm(m, s, 0) = ri;
-		*x(tJ(m, s, 0)) = rJ(s, ri*6);
-		*y(tJ(m, s, 0)) = rJ(s, ri*6+1);
-		*z(tJ(m, s, 0)) = rJ(s, ri*6+2);
+		set_random_row_tJ(m, s, 0, rJ.block(s, ri*6, 1, 3));
 		*x(aJ(m, s, 0)) = rJ(s, ri*6+3);
 		*y(aJ(m, s, 0)) = rJ(s, ri*6+4);
 		*z(aJ(m, s, 0)) = rJ(s, ri*6+5);
@@ -60,9 +160,7 @@ inline void set_random_J(
 		rJ.block(s, ri*6, 1, 6).setRandom();
 
 		*Jm(m, s, 1) = ri;
-		*x(tJ(m, s, 1)) = rJ(s, ri*6);
-		*y(tJ(m, s, 1)) = rJ(s, ri*6+1);
-		*z(tJ(m, s, 1)) = rJ(s, ri*6+2);
+		set_random_row_tJ(m, s, 1, rJ.block(s, ri*6, 1, 3));
 		*x(aJ(m, s, 1)) = rJ(s, ri*6+3);
 		*y(aJ(m, s, 1)) = rJ(s, ri*6+4);
 		*z(aJ(m, s, 1)) = rJ(s, ri*6+5);
@@ -82,6 +180,8 @@ inline void set_random_J(
 		*x(aJ(m, s, 1)) = rJ(s, ri*6+3);
 		*y(aJ(m, s, 1)) = rJ(s, ri*6+4);
 		*z(aJ(m, s, 1)) = rJ(s, ri*6+5);
+
+		activate_contact_row(m, s);
 	}
 }
 
@@ -106,6 +206,8 @@ inline void set_random_Mi(struct mem_t *m, Matrix<real_t, 6*TP_BODIES, 6*TP_BODI
 			for(int col = 0; col < 3; ++col)
 				*ij(Ibi(m, b), row, col) = rMi(i+3+row, i+3+col);
 	}
+
+	update_kinematics(m);
 }
 
 
@@ -150,3 +252,5 @@ inline void set_random_v(struct mem_t *m, Matrix<real_t, 6*TP_BODIES, 1> &rv)
 		*z(omega(m, b)) = rv(b*6 + 5);
 	}
 }
+
+#endif
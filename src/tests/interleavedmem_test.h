@@ -0,0 +1,198 @@
+/*
+ * interleavedmem_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#define TP_MEM		"memory/interleaved.h"
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class interleavedmem_test : public CxxTest::TestSuite
+{
+public:
+
+	void step(struct mem_t *m)
+	{
+		add_foot_forces(m, 0.2, 0.3);
+		step_world(m, 0.005, 20);
+	}
+
+	/** Tests that the accessors of a lane address the same scalar of
+	 * consecutive worlds next to each other, for the memory/interleaved.h
+	 * allocation scheme.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_lane_layout()
+	{
+		struct mem_block_t *block = (struct mem_block_t *)std::malloc(sizeof(struct mem_block_t));
+		struct mem_t lanes[TP_LANES];
+		init_mem_block(block, lanes);
+
+		for(int l = 0; l < (int)(TP_LANES); ++l)
+		{
+			struct mem_t *m = lanes + l;
+
+			TS_ASSERT_EQUALS(pos(m, 1), block->q + (TP_SIZE_VEC3+TP_SIZE_VEC4)*TP_LANES + l);
+			TS_ASSERT_EQUALS(quatern(m, 1), block->q + (2*TP_SIZE_VEC3+TP_SIZE_VEC4)*TP_LANES + l);
+			TS_ASSERT_EQUALS(y(omega(m, 2)), block->v + (2*TP_SIZE_VEC6+4)*TP_LANES + l);
+			TS_ASSERT_EQUALS(ij(R(m, 1), 2, 1), block->R + (3*TP_SIZE_VEC3+2*TP_SIZE_VEC3+1)*TP_LANES + l);
+			TS_ASSERT_EQUALS(q3(quatern(m, 0)), block->q + (TP_SIZE_VEC3+3)*TP_LANES + l);
+			TS_ASSERT_EQUALS(z(aJ(m, 3, 1)), block->J + ((3*2+1)*TP_SIZE_VEC6+5)*TP_LANES + l);
+			TS_ASSERT_EQUALS(Jm(m, 4, 1), block->Jm + (4*2+1)*TP_LANES + l);
+			TS_ASSERT_EQUALS(lambda(m, 5), block->lambda + 5*TP_LANES + l);
+			TS_ASSERT_EQUALS(mm(m, 0), block->mm + l);
+
+			// Write a value unique to the lane and read it back through the other lanes
+			tp_vec3 v = {TP_REAL(l), TP_REAL(l+1), TP_REAL(l+2)};
+			set_vec3(v, ta(m, 2));
+		}
+
+		for(int l = 0; l < (int)(TP_LANES); ++l)
+		{
+			TS_ASSERT_EQUALS(_x(ta(lanes + l, 2)), TP_REAL(l));
+			TS_ASSERT_EQUALS(_y(ta(lanes + l, 2)), TP_REAL(l+1));
+			TS_ASSERT_EQUALS(_z(ta(lanes + l, 2)), TP_REAL(l+2));
+		}
+
+		std::free(block);
+	}
+
+	/** Tests that the worlds of a block are independent, i.e. that stepping a
+	 * world gives the same result regardless of the lane it is stored in.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_lanes_independent()
+	{
+		struct mem_block_t *block = (struct mem_block_t *)std::malloc(sizeof(struct mem_block_t));
+		struct mem_t lanes[TP_LANES];
+		init_mem_block(block, lanes);
+
+		struct mem_block_t *single = (struct mem_block_t *)std::malloc(sizeof(struct mem_block_t));
+		struct mem_t single_lanes[TP_LANES];
+		init_mem_block(single, single_lanes);
+
+		const int probe = TP_LANES - 1;
+
+		for(int l = 0; l < (int)(TP_LANES); ++l)
+		{
+			zero_memory(lanes + l);
+			setup_lying_chain(lanes + l, TP_REAL(0.01)*l);
+		}
+
+		zero_memory(single_lanes);
+		setup_lying_chain(single_lanes, TP_REAL(0.01)*probe);
+
+		for(int s = 0; s < 20; ++s)
+		{
+			for(int l = 0; l < (int)(TP_LANES); ++l)
+				step(lanes + l);
+
+			step(single_lanes);
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			tp_vec3 p0, p1;
+			get_vec3(pos(lanes + probe, b), p0);
+			get_vec3(pos(single_lanes, b), p1);
+
+			TS_ASSERT_EQUALS(p0[0], p1[0]);
+			TS_ASSERT_EQUALS(p0[1], p1[1]);
+			TS_ASSERT_EQUALS(p0[2], p1[2]);
+
+			tp_quatern q0, q1;
+			get_quatern(quatern(lanes + probe, b), q0);
+			get_quatern(quatern(single_lanes, b), q1);
+
+			TS_ASSERT_EQUALS(q0[0], q1[0]);
+			TS_ASSERT_EQUALS(q0[1], q1[1]);
+			TS_ASSERT_EQUALS(q0[2], q1[2]);
+			TS_ASSERT_EQUALS(q0[3], q1[3]);
+		}
+
+		// The worlds started at different heights and must not have been mixed
+		TS_ASSERT_DIFFERS(_z(pos(lanes, 0)), _z(pos(lanes + probe, 0)));
+
+		std::free(block);
+		std::free(single);
+	}
+
+	/** Tests that step_block() steps every lane of a block as step_world()
+	 * does, up to rounding. Every other world connects its bodies in reverse
+	 * order, so that the lanes do not map to the same bodies.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_block()
+	{
+		struct mem_block_t *block = (struct mem_block_t *)std::malloc(sizeof(struct mem_block_t));
+		struct mem_t lanes[TP_LANES];
+		init_mem_block(block, lanes);
+
+		struct mem_block_t *reference = (struct mem_block_t *)std::malloc(sizeof(struct mem_block_t));
+		struct mem_t reference_lanes[TP_LANES];
+		init_mem_block(reference, reference_lanes);
+
+		for(int l = 0; l < (int)(TP_LANES); ++l)
+		{
+			zero_memory(lanes + l);
+			setup_lying_chain(lanes + l, TP_REAL(0.01)*l, l % 2);
+			zero_memory(reference_lanes + l);
+			setup_lying_chain(reference_lanes + l, TP_REAL(0.01)*l, l % 2);
+		}
+
+		for(int s = 0; s < 20; ++s)
+		{
+			for(int l = 0; l < (int)(TP_LANES); ++l)
+			{
+				step(reference_lanes + l);
+
+				collide_foot_cylinder_tri(lanes + l, 0.2, 0.3, 0, TP_BODIES-1);
+				for(int b = 0; b < TP_BODIES; ++b)
+					*z(tFe(lanes + l, b)) += -9.81/_mi(lanes + l, b);
+			}
+
+			step_block(block, 0.005, 20);
+		}
+
+		for(int l = 0; l < (int)(TP_LANES); ++l)
+		{
+			for(int b = 0; b < TP_BODIES; ++b)
+			{
+				TS_ASSERT_DELTA(_x(pos(lanes + l, b)), _x(pos(reference_lanes + l, b)), 1e-4);
+				TS_ASSERT_DELTA(_y(pos(lanes + l, b)), _y(pos(reference_lanes + l, b)), 1e-4);
+				TS_ASSERT_DELTA(_z(pos(lanes + l, b)), _z(pos(reference_lanes + l, b)), 1e-4);
+
+				TS_ASSERT_DELTA(_x(omega(lanes + l, b)), _x(omega(reference_lanes + l, b)), 1e-3);
+				TS_ASSERT_DELTA(_y(omega(lanes + l, b)), _y(omega(reference_lanes + l, b)), 1e-3);
+				TS_ASSERT_DELTA(_z(omega(lanes + l, b)), _z(omega(reference_lanes + l, b)), 1e-3);
+
+				TS_ASSERT_DELTA(_q0(quatern(lanes + l, b)), _q0(quatern(reference_lanes + l, b)), 1e-4);
+				TS_ASSERT_DELTA(_q2(quatern(lanes + l, b)), _q2(quatern(reference_lanes + l, b)), 1e-4);
+			}
+
+			for(int s = 0; s < TP_CONSTRAINTS; ++s)
+				TS_ASSERT_DELTA(_lambda(lanes + l, s), _lambda(reference_lanes + l, s), 1e-2);
+		}
+
+		std::free(block);
+		std::free(reference);
+	}
+};
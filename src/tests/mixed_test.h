@@ -0,0 +1,87 @@
+/*
+ * mixed_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	4
+#define TP_HINGES	3
+#define TP_MOTORS	1
+#define TP_FEET 	0
+
+#define TP_ERP		0.0
+
+#ifndef TP_MIXED_PRECISION
+#define TP_MIXED_PRECISION
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+#include <limits>
+
+class mixed_test : public CxxTest::TestSuite
+{
+public:
+
+	/** A chain of bodies with a motor, moving and under gravity.
+	 */
+	void setup_chain(struct mem_t *m)
+	{
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = b;
+			*x(vel(m, b)) = 0.1 * b;
+			*z(omega(m, b)) = (b % 2) ? 0.5 : -0.5;
+			set_box_inertia(1.0 + b, mi(m, b), 0.5, 0.3, 0.2, Ibi(m, b));
+			*z(tFe(m, b)) = -9.81 / _mi(m, b);
+		}
+
+		tp_vec3 axis = {0.0, 1.0, 0.0};
+		for(int h = 0; h < TP_HINGES; ++h)
+		{
+			tp_vec3 anchor = {TP_REAL(h + 0.5), 0.0, 0.0};
+			create_hinge(m, h, h, h+1, anchor, axis);
+		}
+
+		add_motor(m, 0, 1, 10.0);
+		*mds(m, 0) = 0.5;
+
+		update_kinematics(m);
+		update_jacobian(m);
+	}
+
+	/** Tests that the refinement gives the Lagrange multipliers to the accuracy
+	 * of #real_t, far beyond that of #sweep_real_t in double precision, see
+	 * solve_for_lambda_mixed().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_mixed()
+	{
+		struct mem_t *full = stage_memory(false);
+		struct mem_t *mixed = stage_memory(false);
+
+		setup_chain(full);
+		setup_chain(mixed);
+
+		solve_for_lambda(full, 0.005, 2000);
+		TS_ASSERT_EQUALS(solve_for_lambda_mixed(mixed, 0.005, 2000), 2000);
+
+		const real_t accuracy = 1e4 * std::numeric_limits<real_t>::epsilon();
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(_lambda(mixed, s), _lambda(full, s), accuracy * (1.0 + TP_ABS(_lambda(full, s))));
+
+		free(full);
+		free(mixed);
+	}
+};
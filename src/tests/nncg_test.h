@@ -0,0 +1,101 @@
+/*
+ * nncg_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	6
+#define TP_HINGES	5
+#define TP_MOTORS	1
+#define TP_FEET 	0
+
+#define TP_ERP		0.0
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class nncg_test : public CxxTest::TestSuite
+{
+public:
+
+	/** A chain of bodies with alternating heavy and light bodies, and a motor.
+	 */
+	void setup_chain(struct mem_t *m)
+	{
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = b;
+			*x(vel(m, b)) = 0.1 * b;
+			*z(omega(m, b)) = (b % 2) ? 0.5 : -0.5;
+			set_box_inertia((b % 2) ? 0.1 : 10.0, mi(m, b), 0.5, 0.3, 0.2, Ibi(m, b));
+			*z(tFe(m, b)) = -9.81 / _mi(m, b);
+		}
+
+		tp_vec3 axis = {0.0, 1.0, 0.0};
+		for(int h = 0; h < TP_HINGES; ++h)
+		{
+			tp_vec3 anchor = {TP_REAL(h + 0.5), 0.0, 0.0};
+			create_hinge(m, h, h, h+1, anchor, axis);
+		}
+
+		add_motor(m, 0, 2, 10.0);
+		*mds(m, 0) = 0.5;
+
+		update_kinematics(m);
+		update_jacobian(m);
+	}
+
+	/** Tests that the conjugate gradient solver converges to the same Lagrange
+	 * multipliers as Projected Gauss-Seidel, in fewer iterations, see
+	 * solve_for_lambda_nncg().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_nncg()
+	{
+		struct mem_t *pgs = stage_memory(false);
+		struct mem_t *nncg = stage_memory(false);
+
+		setup_chain(pgs);
+		setup_chain(nncg);
+
+		const int max_iterations = 5000;
+
+		int pgs_iterations = solve_for_lambda(pgs, 0.005, max_iterations, 1e-5);
+		int nncg_iterations = solve_for_lambda_nncg(nncg, 0.005, max_iterations, 1e-5);
+
+		TS_ASSERT_LESS_THAN(nncg_iterations, pgs_iterations / 2);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(_lambda(nncg, s), _lambda(pgs, s), 1e-2 * (1.0 + TP_ABS(_lambda(pgs, s))));
+
+		free(pgs);
+		free(nncg);
+	}
+
+	/** Tests that the conjugate steps keep the multipliers within their limits.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_nncg_limits()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		setup_chain(m);
+		solve_for_lambda_nncg(m, 0.005, 50);
+
+		TS_ASSERT(_lambda(m, TP_HINGE_CONSTRAINTS) <= _lambda_max(m, TP_HINGE_CONSTRAINTS));
+		TS_ASSERT(_lambda(m, TP_HINGE_CONSTRAINTS) >= _lambda_min(m, TP_HINGE_CONSTRAINTS));
+
+		free(m);
+	}
+};
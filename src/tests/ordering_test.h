@@ -0,0 +1,121 @@
+/*
+ * ordering_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	8
+#define TP_HINGES	7
+#define TP_MOTORS	2
+#define TP_FEET 	1
+
+#ifndef TP_SYMMETRIC_SWEEPS
+#define TP_SYMMETRIC_SWEEPS
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class ordering_test : public CxxTest::TestSuite
+{
+public:
+
+	/** A leg standing on its foot, the first body, with a heavy body on top.
+	 */
+	void setup_leg(struct mem_t *m)
+	{
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*z(pos(m, b)) = 0.1 + 0.5*b;
+			set_box_inertia((b == TP_BODIES-1) ? 20.0 : 1.0, mi(m, b), 0.2, 0.2, 0.5, Ibi(m, b));
+		}
+
+		tp_vec3 axis = {0.0, 1.0, 0.0};
+		for(int h = 0; h < TP_HINGES; ++h)
+		{
+			tp_vec3 anchor = {0.0, 0.0, TP_REAL(0.35 + 0.5*h)};
+			create_hinge(m, h, h, h+1, anchor, axis);
+		}
+
+		add_motor(m, 0, 1, 100.0);
+		add_motor(m, 1, 4, 100.0);
+
+		update_kinematics(m);
+	}
+
+	void add_forces(struct mem_t *m)
+	{
+		collide_foot_cylinder_tri(m, 0.2, 0.3, 0, 0);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+			*z(tFe(m, b)) += -9.81/_mi(m, b);
+
+		update_jacobian(m);
+	}
+
+	/** Tests that the rows are ordered from the top to the foot, see order_rows().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_order_rows()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_leg(m);
+
+		for(int r = 0; r < TP_HINGE_MOTOR_CONSTRAINTS; ++r)
+			TS_ASSERT_EQUALS(_rorder(m, r), r);
+
+		index_t foot = 0;
+		order_rows(m, &foot, 1);
+
+		for(int h = 0; h < TP_HINGES; ++h)
+			for(int k = 0; k < 5; ++k)
+				TS_ASSERT_EQUALS(_rorder(m, 5*h + k), 5*(TP_HINGES-1-h) + k);
+
+		// The motor of hinge 4 is further from the foot
+		TS_ASSERT_EQUALS(_rorder(m, TP_HINGE_CONSTRAINTS), TP_HINGE_CONSTRAINTS + 1);
+		TS_ASSERT_EQUALS(_rorder(m, TP_HINGE_CONSTRAINTS + 1), TP_HINGE_CONSTRAINTS);
+
+		free(m);
+	}
+
+	/** Tests that ordered symmetric sweeps reach the same Lagrange multipliers in
+	 * fewer iterations, see sweep_rows().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_ordered_sweeps()
+	{
+		struct mem_t *plain = stage_memory(false);
+		struct mem_t *ordered = stage_memory(false);
+
+		setup_leg(plain);
+		setup_leg(ordered);
+
+		index_t foot = 0;
+		order_rows(ordered, &foot, 1);
+
+		add_forces(plain);
+		add_forces(ordered);
+
+		int plain_iterations = solve_for_lambda(plain, 0.005, 100000, 1e-4);
+		int ordered_iterations = solve_for_lambda(ordered, 0.005, 100000, 1e-4);
+
+		TS_ASSERT_LESS_THAN(ordered_iterations, plain_iterations);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(_lambda(ordered, s), _lambda(plain, s), 1e-2 * (1.0 + TP_ABS(_lambda(plain, s))));
+
+		free(plain);
+		free(ordered);
+	}
+};
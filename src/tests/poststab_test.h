@@ -0,0 +1,134 @@
+/*
+ * poststab_test.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#ifndef TP_POST_STABILIZATION
+#define TP_POST_STABILIZATION
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+class poststab_test : public CxxTest::TestSuite
+{
+public:
+
+	/** Tests that a displaced body is moved back by the #TP_ERP fraction of the
+	 * error, and that the velocities, Lagrange multipliers and motor limits of the
+	 * step are kept, see project_positions().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_project_positions()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_leg(m, 1.0);
+
+		step_world(m, 0.01, 20);
+
+		real_t lambda_step[TP_HINGE_MOTOR_CONSTRAINTS];
+		for(int s = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s)
+			lambda_step[s] = _lambda(m, s);
+
+		real_t vz = _z(vel(m, 2));
+
+		const real_t offset = 0.01;
+		*x(pos(m, 2)) += offset;
+		update_kinematics(m);
+		TS_ASSERT_DELTA(joint_drift(m), offset, 1e-4);
+
+		project_positions(m, 0.01, 50);
+		update_kinematics(m);
+
+		TS_ASSERT(joint_drift(m) < (TP_REAL(1.0) - (TP_ERP))*offset + TP_REAL(1e-4));
+
+		for(int s = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s)
+			TS_ASSERT_EQUALS(_lambda(m, s), lambda_step[s]);
+
+		TS_ASSERT_EQUALS(_z(vel(m, 2)), vz);
+
+		TS_ASSERT_EQUALS(_lambda_min(m, TP_HINGE_CONSTRAINTS), -10.0);
+		TS_ASSERT_EQUALS(_lambda_max(m, TP_HINGE_CONSTRAINTS), 10.0);
+
+		free(m);
+	}
+
+	/** Tests that the motor holds the angle of its hinge in the projection within
+	 * its force limit scaled by the square of the timestep, and gives way to the
+	 * projection of the other hinge beyond it, see project_positions().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_motor_limit()
+	{
+		real_t motor_angle[2];
+
+		for(int i = 0; i < 2; ++i)
+		{
+			struct mem_t *m = stage_memory(false);
+			setup_leg(m, 1.0);
+
+			// A torque of 1 is too weak to hold the hinge, 10 is not
+			real_t max_torque = (i == 0) ? 1.0 : 10.0;
+			*lambda_min(m, TP_HINGE_CONSTRAINTS) = -max_torque;
+			*lambda_max(m, TP_HINGE_CONSTRAINTS) = max_torque;
+
+			step_world(m, 0.01, 20);
+
+			*x(pos(m, 2)) += 0.01;
+			update_kinematics(m);
+
+			project_positions(m, 0.01, 50);
+
+			motor_angle[i] = _q2(quatern(m, 1)) - _q2(quatern(m, 0));
+
+			free(m);
+		}
+
+		TS_ASSERT(fabs(motor_angle[0]) > 1e-2);
+		TS_ASSERT_DELTA(motor_angle[1], 0.0, 1e-6);
+	}
+
+	/** Tests that the joints stay together after a motor kicks the leg into fast
+	 * rotation, without a velocity bias in the solver, see project_positions(). With
+	 * the bias instead the joints drift apart almost ten times as far.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_motor_kick()
+	{
+		struct mem_t *m = stage_memory(false);
+		setup_leg(m, 1.0);
+
+		real_t drift = 0.0;
+
+		for(int step = 0; step < 40; ++step)
+		{
+			if(step == 10) *mds(m, 0) = 10.0;
+
+			add_foot_forces(m, 0.05, 0.1);
+			step_world(m, 0.02, 20);
+
+			if(joint_drift(m) > drift) drift = joint_drift(m);
+		}
+
+		TS_ASSERT(drift < 1e-2);
+
+		free(m);
+	}
+};
@@ -0,0 +1,187 @@
+/*
+ * sharedmem_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#define TP_THREADS	4
+
+#define TP_MEM		"memory/shared.h"
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+#include <tp/batch.h>
+
+#include "helpers.h"
+
+class sharedmem_test : public CxxTest::TestSuite
+{
+public:
+
+	void setup_prototype(struct mem_t *m, struct model_t *model)
+	{
+		m->model = model;
+		zero_model(model);
+		zero_memory(m);
+
+		setup_lying_chain(m, 0.0);
+	}
+
+	void clone_world(struct mem_t *clone, const struct mem_t *prototype, real_t offset)
+	{
+		*clone = *prototype;
+
+		for(int b = 0; b < TP_BODIES; ++b)
+			*z(pos(clone, b)) += offset;
+	}
+
+	/** Tests that worlds copied from a configured world share its model data,
+	 * but have their own state, for the memory/shared.h allocation scheme.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_model_shared()
+	{
+		struct model_t model;
+		struct mem_t prototype, clone;
+
+		setup_prototype(&prototype, &model);
+		clone_world(&clone, &prototype, 0.05);
+
+		TS_ASSERT_EQUALS(mi(&clone, 1), mi(&prototype, 1));
+		TS_ASSERT_EQUALS(Ibi(&clone, 2), Ibi(&prototype, 2));
+		TS_ASSERT_EQUALS(haxis(&clone, 1), haxis(&prototype, 1));
+		TS_ASSERT_EQUALS(hanchor(&clone, 0, 1), hanchor(&prototype, 0, 1));
+		TS_ASSERT_EQUALS(mm(&clone, 0), mm(&prototype, 0));
+		TS_ASSERT_EQUALS(lambda_max(&clone, TP_HINGE_CONSTRAINTS), lambda_max(&prototype, TP_HINGE_CONSTRAINTS));
+
+		TS_ASSERT_DIFFERS(pos(&clone, 1), pos(&prototype, 1));
+		TS_ASSERT_DIFFERS(lambda(&clone, 0), lambda(&prototype, 0));
+		TS_ASSERT_DIFFERS(lambda_min(&clone, TP_HINGE_MOTOR_CONSTRAINTS), lambda_min(&prototype, TP_HINGE_MOTOR_CONSTRAINTS));
+
+		TS_ASSERT_EQUALS(_lambda_max(&clone, TP_HINGE_CONSTRAINTS), TP_REAL(1.0));
+		TS_ASSERT_EQUALS(_lambda_min(&clone, TP_HINGE_CONSTRAINTS), TP_REAL(-1.0));
+		TS_ASSERT_DELTA(_z(pos(&clone, 0)) - _z(pos(&prototype, 0)), 0.05, 1e-6);
+
+		// Contact bounds belong to the world
+		*lambda_min(&clone, TP_HINGE_MOTOR_CONSTRAINTS) = TP_REAL(0.0);
+		TS_ASSERT_EQUALS(_lambda_min(&prototype, TP_HINGE_MOTOR_CONSTRAINTS), TP_REAL(-1048576.0));
+	}
+
+	/** Tests that worlds sharing a model, and solver work memory within each
+	 * thread, step as if they were stepped one by one.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_worlds_shared()
+	{
+		const size_t n = 37;
+
+		struct model_t model;
+		struct mem_t prototype;
+		setup_prototype(&prototype, &model);
+
+		struct mem_t *batch = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+		struct mem_t *serial = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			clone_world(batch + w, &prototype, TP_REAL(0.01)*w);
+			clone_world(serial + w, &prototype, TP_REAL(0.01)*w);
+		}
+
+		for(int step = 0; step < 20; ++step)
+		{
+			for(size_t w = 0; w < n; ++w)
+			{
+				add_foot_forces(batch + w, 0.2, 0.3);
+				add_foot_forces(serial + w, 0.2, 0.3);
+			}
+
+			step_worlds(batch, n, 0.005, 20);
+
+			for(size_t w = 0; w < n; ++w)
+				step_world(serial + w, 0.005, 20);
+		}
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			for(int b = 0; b < TP_BODIES; ++b)
+			{
+				TS_ASSERT_EQUALS(_x(pos(batch + w, b)), _x(pos(serial + w, b)));
+				TS_ASSERT_EQUALS(_y(pos(batch + w, b)), _y(pos(serial + w, b)));
+				TS_ASSERT_EQUALS(_z(pos(batch + w, b)), _z(pos(serial + w, b)));
+
+				TS_ASSERT_EQUALS(_q0(quatern(batch + w, b)), _q0(quatern(serial + w, b)));
+				TS_ASSERT_EQUALS(_q2(quatern(batch + w, b)), _q2(quatern(serial + w, b)));
+			}
+		}
+
+		// The worlds started at different heights and must not have been mixed
+		TS_ASSERT_DIFFERS(_z(pos(batch, 0)), _z(pos(batch + n - 1, 0)));
+
+		std::free(batch);
+		std::free(serial);
+	}
+
+	/** Tests that a world sharing its model is solved on the threads of a pool
+	 * as on one thread, and close to the serial solver, although the threads have
+	 * their own solver work memory, see solve_for_lambda_parallel().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_world_parallel_shared()
+	{
+		struct pool_t one, three;
+		init_pool(&one, 1);
+		init_pool(&three, 3);
+
+		struct model_t model;
+		struct mem_t prototype, w1, w3, serial;
+		setup_prototype(&prototype, &model);
+
+		clone_world(&w1, &prototype, 0.0);
+		clone_world(&w3, &prototype, 0.0);
+		clone_world(&serial, &prototype, 0.0);
+
+		struct colouring_t colouring;
+		colour_hinges(&w1, &colouring);
+
+		for(int step = 0; step < 20; ++step)
+		{
+			add_foot_forces(&w1, 0.2, 0.3);
+			add_foot_forces(&w3, 0.2, 0.3);
+			add_foot_forces(&serial, 0.2, 0.3);
+
+			step_world_parallel(&one, &w1, &colouring, 0.005, 100);
+			step_world_parallel(&three, &w3, &colouring, 0.005, 100);
+			step_world(&serial, 0.005, 100);
+		}
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			TS_ASSERT_EQUALS(_x(pos(&w1, b)), _x(pos(&w3, b)));
+			TS_ASSERT_EQUALS(_z(pos(&w1, b)), _z(pos(&w3, b)));
+
+			TS_ASSERT_DELTA(_x(pos(&w3, b)), _x(pos(&serial, b)), 1e-4);
+			TS_ASSERT_DELTA(_z(pos(&w3, b)), _z(pos(&serial, b)), 1e-4);
+		}
+
+		// The bodies are held by the hinges, not falling freely
+		TS_ASSERT_DIFFERS(_z(pos(&w3, 0)), _z(pos(&w3, TP_BODIES-1)));
+
+		destroy_pool(&one);
+		destroy_pool(&three);
+	}
+};
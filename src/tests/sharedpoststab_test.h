@@ -0,0 +1,100 @@
+/*
+ * sharedpoststab_test.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#define TP_BODIES	3
+#define TP_HINGES	2
+#define TP_MOTORS	1
+#define TP_FEET 	1
+
+#define TP_THREADS	8
+
+#define TP_MEM		"memory/shared.h"
+
+#ifndef TP_POST_STABILIZATION
+#define TP_POST_STABILIZATION
+#endif
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+#include <tp/batch.h>
+
+#include "helpers.h"
+
+class sharedpoststab_test : public CxxTest::TestSuite
+{
+public:
+
+	void setup_prototype(struct mem_t *m, struct model_t *model)
+	{
+		m->model = model;
+		zero_model(model);
+		zero_memory(m);
+
+		setup_leg(m, 0.3, 5.0);
+	}
+
+	/** Tests that worlds sharing a model are projected in parallel as one by one,
+	 * that is, the projection does not write the motor limits of the shared model,
+	 * see project_positions().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_step_worlds_projection()
+	{
+		const size_t n = 256;
+
+		struct model_t model;
+		struct mem_t prototype;
+		setup_prototype(&prototype, &model);
+
+		struct mem_t *batch = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+		struct mem_t *serial = (struct mem_t *)std::malloc(n*sizeof(struct mem_t));
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			batch[w] = prototype;
+			for(int b = 0; b < TP_BODIES; ++b)
+				*z(pos(batch + w, b)) += TP_REAL(0.001)*w;
+
+			serial[w] = batch[w];
+		}
+
+		for(int step = 0; step < 40; ++step)
+		{
+			for(size_t w = 0; w < n; ++w)
+			{
+				add_foot_forces(batch + w, 0.05, 0.1);
+				add_foot_forces(serial + w, 0.05, 0.1);
+			}
+
+			step_worlds(batch, n, 0.01, 20);
+
+			for(size_t w = 0; w < n; ++w)
+				step_world(serial + w, 0.01, 20);
+		}
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			for(int b = 0; b < TP_BODIES; ++b)
+			{
+				TS_ASSERT_EQUALS(_x(pos(batch + w, b)), _x(pos(serial + w, b)));
+				TS_ASSERT_EQUALS(_z(pos(batch + w, b)), _z(pos(serial + w, b)));
+			}
+		}
+
+		TS_ASSERT_EQUALS(_lambda_min(&prototype, TP_HINGE_CONSTRAINTS), -10.0);
+		TS_ASSERT_EQUALS(_lambda_max(&prototype, TP_HINGE_CONSTRAINTS), 10.0);
+
+		std::free(batch);
+		std::free(serial);
+	}
+};
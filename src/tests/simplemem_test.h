@@ -15,6 +15,9 @@
 #define TP_MOTORS	2
 #define TP_FEET 	0
 
+// Tests below fill the full Jacobian layout
+#undef TP_COMPACT_JACOBIAN
+
 #include <tp/tp-core.h>
 #include <debugging/debugging.h>
 #include <tp/tp.h>
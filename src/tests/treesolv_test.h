@@ -0,0 +1,174 @@
+/*
+ * treesolv_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+// Tests below relies on these values
+#define TP_BODIES	4
+#define TP_HINGES	3
+#define TP_MOTORS	0
+#define TP_FEET 	0
+
+#define TP_ERP		0.0
+
+#define TP_TREE_SOLVER
+
+#include <tp/tp-core.h>
+#include <debugging/debugging.h>
+#include <tp/tp.h>
+
+#include "helpers.h"
+
+#include <Eigen/LU>
+
+class treesolv_test : public CxxTest::TestSuite
+{
+public:
+
+	// Solves the hinge rows of a branching chain by one sweep, and compares to a dense solve
+	void solve_branching_chain(bool fixed_root)
+	{
+		struct mem_t *m = stage_memory(false);
+
+		real_t dt = 1.0;
+
+		// A body with two children, one of which has a child
+		real_t masses[TP_BODIES] = {10.0, 1.0, 2.0, 0.5};
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = (b == 3) ? 2.0 : (b == 0) ? 0.0 : 1.0;
+			*y(pos(m, b)) = (b == 2) ? 1.0 : 0.0;
+			set_box_inertia(masses[b], mi(m, b), 0.5, 0.3, 0.2, Ibi(m, b));
+		}
+
+		// Infinite mass
+		if(fixed_root)
+		{
+			*mi(m, 0) = 0.0;
+			for(int r = 0; r < 3; ++r)
+				for(int c = 0; c < 3; ++c)
+					*ij(Ibi(m, 0), r, c) = 0.0;
+		}
+
+		tp_vec3 axis0 = {0.0, 1.0, 0.0}, anchor0 = {0.5, 0.0, 0.0};
+		tp_vec3 axis1 = {1.0, 0.0, 0.0}, anchor1 = {0.5, 0.5, 0.0};
+		tp_vec3 axis2 = {0.0, 0.0, 1.0}, anchor2 = {1.5, 0.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor0, axis0);
+		create_hinge(m, 1, 2, 0, anchor1, axis1);
+		create_hinge(m, 2, 1, 3, anchor2, axis2);
+
+		update_kinematics(m);
+		update_jacobian(m);
+
+		Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES> rJ = Matrix<real_t, TP_CONSTRAINTS, 6*TP_BODIES>::Zero();
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+		{
+			for(int bi = 0; bi < 2; ++bi)
+			{
+				index_t body = _Jm(m, s, bi);
+
+				tp_vec3 _tJ, _aJ;
+				get_row_tJ(m, s, bi, _tJ);
+				get_vec3(aJ(m, s, bi), _aJ);
+
+				for(int k = 0; k < 3; ++k)
+				{
+					rJ(s, body*6+k) = _tJ[k];
+					rJ(s, body*6+3+k) = _aJ[k];
+				}
+			}
+		}
+
+		Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES> rMi = Matrix<real_t, 6*TP_BODIES, 6*TP_BODIES>::Zero();
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			for(int k = 0; k < 3; ++k)
+				rMi(b*6+k, b*6+k) = _mi(m, b);
+
+			for(int r = 0; r < 3; ++r)
+				for(int c = 0; c < 3; ++c)
+					rMi(b*6+3+r, b*6+3+c) = _ij(Iwi(m, b), r, c);
+		}
+
+		Matrix<real_t, 6*TP_BODIES, 1> rv;
+		set_random_v(m, rv);
+
+		Matrix<real_t, 6*TP_BODIES, 1> rFe;
+		set_random_Fe(m, rFe);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rrhs = -rJ * (1/dt * rv + rMi * rFe);
+		Matrix<real_t, TP_CONSTRAINTS, TP_CONSTRAINTS> A = rJ * rMi * rJ.transpose();
+
+		TS_ASSERT_EQUALS(solve_for_lambda(m, dt, 1), 1);
+
+		Matrix<real_t, TP_CONSTRAINTS, 1> rlambda = A.partialPivLu().solve(rrhs);
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s)
+			TS_ASSERT_DELTA(rlambda(s), _lambda(m, s), 1e-2);
+
+		free(m);
+	}
+
+	/** Tests that a single sweep of the tree solver solves the hinge rows of a
+	 * branching chain exactly, see solve_tree().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_solve_tree()
+	{
+		solve_branching_chain(false);
+	}
+
+	/** Tests that a body of infinite mass is fixed by the tree solver, see
+	 * factor_tree().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_fixed_body()
+	{
+		solve_branching_chain(true);
+	}
+
+	/** Tests that hinges forming a loop are detected, see factor_tree().
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_loop()
+	{
+		struct mem_t *m = stage_memory(false);
+
+		for(int b = 0; b < TP_BODIES; ++b)
+		{
+			*x(pos(m, b)) = b;
+			set_box_inertia(1.0, mi(m, b), 0.5, 0.5, 0.5, Ibi(m, b));
+		}
+
+		tp_vec3 axis = {0.0, 1.0, 0.0};
+		tp_vec3 anchor = {0.5, 0.0, 0.0};
+		create_hinge(m, 0, 0, 1, anchor, axis);
+		create_hinge(m, 1, 1, 2, anchor, axis);
+		create_hinge(m, 2, 2, 0, anchor, axis);
+
+		update_kinematics(m);
+		update_jacobian(m);
+
+		struct tree_t tree;
+		TS_ASSERT_EQUALS(_tnode(m, 0), -1);
+		TS_ASSERT(!factor_tree(m, &tree));
+
+		create_hinge(m, 2, 2, 3, anchor, axis);
+		update_kinematics(m);
+		update_jacobian(m);
+
+		TS_ASSERT(factor_tree(m, &tree));
+
+		free(m);
+	}
+};
+
@@ -0,0 +1,155 @@
+/*
+ * world_test.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#include <tp/world.h>
+
+typedef tp::World<3, 2, 1, 1> chain3;
+typedef tp::World<5, 4, 2, 2> chain5;
+
+class world_test : public CxxTest::TestSuite
+{
+public:
+
+	template<class W>
+	void setup_world(typename W::mem_t *m, double offset)
+	{
+		typedef typename W::real_t real_t;
+
+		typename W::tp_quatern eq = {1.0, 0.0, 0.0, 0.0};
+		typename W::tp_mtx33 eR;
+		W::quaternion_to_rot_mtx33(eq, eR);
+
+		for(int b = 0; b < W::bodies; ++b)
+		{
+			W::set_quatern(eq, W::quatern(m, b));
+			W::set_mtx33(eR, W::R(m, b));
+
+			*W::x(W::pos(m, b)) = b;
+			*W::z(W::pos(m, b)) = 0.1 + offset;
+
+			W::set_box_inertia(1.0 + b, W::mi(m, b), 0.5, 0.5, 0.5, W::Ibi(m, b));
+		}
+
+		typename W::tp_vec3 axis = {0.0, 1.0, 0.0};
+		for(int h = 0; h < W::bodies - 1; ++h)
+		{
+			typename W::tp_vec3 anchor = {real_t(h + 0.5), 0.0, real_t(0.1 + offset)};
+			W::create_hinge(m, h, h, h+1, anchor, axis);
+		}
+
+		W::add_motor(m, 0, 0, 1.0);
+		*W::mds(m, 0) = 0.5;
+
+		W::update_kinematics(m);
+	}
+
+	template<class W>
+	void add_forces(typename W::mem_t *m)
+	{
+		W::collide_foot_cylinder_tri(m, 0.2, 0.3, 0, W::bodies - 1);
+
+		for(int b = 0; b < W::bodies; ++b)
+			*W::z(W::tFe(m, b)) += -9.81/W::_mi(m, b);
+	}
+
+	/** Tests that worlds of two models of different size are allocated from one arena,
+	 * and that stepping both on one pool gives the same result as stepping the worlds
+	 * one by one, see tp::World.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_mixed_models()
+	{
+		TS_ASSERT_EQUALS(chain3::constraints, 5*2 + 1 + TP_CONTACT_CONSTRAINTS);
+		TS_ASSERT_EQUALS(chain5::constraints, 5*4 + 2 + 2*TP_CONTACT_CONSTRAINTS);
+		TS_ASSERT(sizeof(chain3::mem_t) < sizeof(chain5::mem_t));
+
+		const size_t n = 9;
+
+		struct tp::arena_t arena;
+		tp::init_arena(&arena, 4*n*(sizeof(chain3::mem_t) + sizeof(chain5::mem_t)) + 1024);
+
+		chain3::mem_t *batch3 = chain3::create(&arena, n);
+		chain3::mem_t *serial3 = chain3::create(&arena, n);
+		chain5::mem_t *batch5 = chain5::create(&arena, n);
+		chain5::mem_t *serial5 = chain5::create(&arena, n);
+
+		TS_ASSERT(batch3 && serial3 && batch5 && serial5);
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			setup_world<chain3>(batch3 + w, 0.01*w);
+			setup_world<chain3>(serial3 + w, 0.01*w);
+			setup_world<chain5>(batch5 + w, 0.01*w);
+			setup_world<chain5>(serial5 + w, 0.01*w);
+		}
+
+		struct pool_t pool;
+		init_pool(&pool, 3);
+
+		for(int step = 0; step < 20; ++step)
+		{
+			for(size_t w = 0; w < n; ++w)
+			{
+				add_forces<chain3>(batch3 + w);
+				add_forces<chain3>(serial3 + w);
+				add_forces<chain5>(batch5 + w);
+				add_forces<chain5>(serial5 + w);
+			}
+
+			chain3::step_worlds(&pool, batch3, n, 0.005, 20);
+			chain5::step_worlds(&pool, batch5, n, 0.005, 20);
+
+			for(size_t w = 0; w < n; ++w)
+			{
+				chain3::step_world(serial3 + w, 0.005, 20);
+				chain5::step_world(serial5 + w, 0.005, 20);
+			}
+		}
+
+		for(size_t w = 0; w < n; ++w)
+		{
+			for(int b = 0; b < chain3::bodies; ++b)
+				TS_ASSERT_EQUALS(chain3::_z(chain3::pos(batch3 + w, b)), chain3::_z(chain3::pos(serial3 + w, b)));
+
+			for(int b = 0; b < chain5::bodies; ++b)
+				TS_ASSERT_EQUALS(chain5::_z(chain5::pos(batch5 + w, b)), chain5::_z(chain5::pos(serial5 + w, b)));
+
+			// The chains fall and stay together
+			TS_ASSERT(chain5::_z(chain5::pos(batch5 + w, 0)) < 0.1 + 0.01*w);
+			TS_ASSERT_DELTA(chain5::_x(chain5::pos(batch5 + w, 4)) - chain5::_x(chain5::pos(batch5 + w, 0)), 4.0, 1e-2);
+		}
+
+		destroy_pool(&pool);
+		tp::destroy_arena(&arena);
+	}
+
+	/** Tests that an arena returns 64 byte aligned memory, and no memory when full.
+	 *
+	 * @ingroup tp-tests
+	 */
+	void test_arena()
+	{
+		struct tp::arena_t arena;
+		tp::init_arena(&arena, 256);
+
+		char *first = (char *)tp::arena_alloc(&arena, 10);
+		char *second = (char *)tp::arena_alloc(&arena, 100);
+
+		TS_ASSERT_EQUALS((size_t)first % 64, 0u);
+		TS_ASSERT_EQUALS(second - first, 64);
+
+		TS_ASSERT(tp::arena_alloc(&arena, 1000) == 0);
+		TS_ASSERT(tp::arena_alloc(&arena, 10) != 0);
+
+		tp::destroy_arena(&arena);
+	}
+};
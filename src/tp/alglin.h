@@ -405,6 +405,114 @@ void mult_to_mtx33T_vec3(const tp_mtx33 mtx, tp_vec3 vec)
 	vec[1] = tmp2;
 }
 
+/** Inverts a square matrix of size at most 6x6.
+ *
+ * Inverts the row major @a n x @a n matrix @a mtx by Gauss-Jordan elimination with
+ * partial pivoting. If a pivot is too small the matrix is considered singular,
+ * @a result is then left undefined and @b false is returned.
+ *
+ * @param[out]		result			The matrix to store the inverse in.
+ * @param[in]		mtx				Input matrix.
+ * @param			n				Number of rows and columns, in interval [1, 6].
+ * @return @b true if inversion successful, @b false if unsuccessful.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_INLINE
+bool invert_mtxn(real_t *result, const real_t *mtx, int n)
+{
+	real_t A[36];
+	for(int i = 0; i < n*n; ++i)
+	{
+		A[i] = mtx[i];
+		result[i] = (i % (n+1) == 0) ? TP_REAL(1.0) : TP_REAL(0.0);
+	}
+
+	for(int col = 0; col < n; ++col)
+	{
+		int pivot = col;
+		for(int row = col+1; row < n; ++row)
+			if(TP_ABS(A[row*n+col]) > TP_ABS(A[pivot*n+col])) pivot = row;
+
+		if(TP_ABS(A[pivot*n+col]) < TP_REAL(1e-7)) return false;
+
+		for(int k = 0; k < n; ++k)
+		{
+			real_t tmp = A[col*n+k];
+			A[col*n+k] = A[pivot*n+k];
+			A[pivot*n+k] = tmp;
+
+			tmp = result[col*n+k];
+			result[col*n+k] = result[pivot*n+k];
+			result[pivot*n+k] = tmp;
+		}
+
+		real_t scale = TP_REAL(1.0) / A[col*n+col];
+		for(int k = 0; k < n; ++k)
+		{
+			A[col*n+k] *= scale;
+			result[col*n+k] *= scale;
+		}
+
+		for(int row = 0; row < n; ++row)
+		{
+			if(row == col) continue;
+
+			real_t mult = A[row*n+col];
+			for(int k = 0; k < n; ++k)
+			{
+				A[row*n+k] -= mult*A[col*n+k];
+				result[row*n+k] -= mult*result[col*n+k];
+			}
+		}
+	}
+
+	return true;
+}
+
+/** Inverts a 5x5 matrix.
+ *
+ * Inverts the row major matrix @a mtx, see invert_mtxn().
+ *
+ * @param[out]		result			The matrix to store the inverse in.
+ * @param[in]		mtx				Input matrix.
+ * @return @b true if inversion successful, @b false if unsuccessful.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_INLINE
+bool invert_mtx55(real_t result[25], const real_t mtx[25])
+{
+	return invert_mtxn(result, mtx, 5);
+}
+
+/** Inverts a 3x3 matrix.
+ *
+ * Inverts @a mtx, see invert_mtxn().
+ *
+ * @param[out]		result			The matrix to store the inverse in.
+ * @param[in]		mtx				Input matrix.
+ * @return @b true if inversion successful, @b false if unsuccessful.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_INLINE
+bool invert_mtx33(tp_mtx33 result, const tp_mtx33 mtx)
+{
+	real_t A[9], Ai[9];
+	for(int i = 0; i < 3; ++i)
+		for(int j = 0; j < 3; ++j)
+			A[i*3+j] = mtx[i*TP_SIZE_VEC3+j];
+
+	if(!invert_mtxn(Ai, A, 3)) return false;
+
+	for(int i = 0; i < 3; ++i)
+		for(int j = 0; j < 3; ++j)
+			result[i*TP_SIZE_VEC3+j] = Ai[i*3+j];
+
+	return true;
+}
+
 /** Converts a quaternion to a 3x3 rotation matrix.
  *
  * @param[in]		q			Quaternion to convert.
@@ -469,6 +577,53 @@ void mult_quatern_quatern(tp_quatern result, const tp_quatern qa, const tp_quate
 	result[3] = qa[0]*qb[3] + qa[1]*qb[2] - qa[2]*qb[1] + qa[3]*qb[0];
 }
 
+/** Rotates a quaternion by a constant angular velocity during a timestep.
+ *
+ * Computes \f$q' = \exp(\frac{1}{2}\omega\,dt) \otimes q\f$, the exact rotation by the
+ * angle \f$|\omega|dt\f$ about \f$\omega\f$. Unlike the first order update
+ * \f$q + \frac{dt}{2}\,\omega \otimes q\f$ it keeps @a q of unit length, up to
+ * rounding, which is removed by one Newton step of the normalization instead of a
+ * square root. If the half angle is small the sine and cosine are replaced by their
+ * Taylor series, which are accurate to rounding there.
+ *
+ * @param[in,out]	q				Unit quaternion to rotate.
+ * @param[in]		omega			Angular velocity, in world coordinates.
+ * @param			dt				Timestep.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_INLINE
+void integrate_quaternion_exp(tp_quatern q, const tp_vec3 omega, real_t dt)
+{
+	real_t norm2 = dot_vec3(omega, omega);
+	real_t half_angle2 = TP_REAL(0.25)*dt*dt*norm2;
+
+	// cos(|omega|dt/2), and sin(|omega|dt/2)/|omega|
+	real_t c, s;
+	if(half_angle2 < TP_REAL(1e-4))
+	{
+		c = TP_REAL(1.0) - half_angle2*(TP_REAL(1.0)/TP_REAL(2.0) - half_angle2*(TP_REAL(1.0)/TP_REAL(24.0)));
+		s = TP_REAL(0.5)*dt*(TP_REAL(1.0) - half_angle2*(TP_REAL(1.0)/TP_REAL(6.0) - half_angle2*(TP_REAL(1.0)/TP_REAL(120.0))));
+	}
+	else
+	{
+		real_t norm = TP_SQRT(norm2);
+		c = TP_COS(TP_REAL(0.5)*dt*norm);
+		s = TP_SIN(TP_REAL(0.5)*dt*norm) / norm;
+	}
+
+	tp_quatern dq = {c, s*omega[0], s*omega[1], s*omega[2]};
+
+	tp_quatern result;
+	mult_quatern_quatern(result, dq, q);
+
+	real_t scale = TP_REAL(0.5)*(TP_REAL(3.0) - (result[0]*result[0] + result[1]*result[1] + result[2]*result[2] + result[3]*result[3]));
+	q[0] = scale*result[0];
+	q[1] = scale*result[1];
+	q[2] = scale*result[2];
+	q[3] = scale*result[3];
+}
+
 /** Normalizes a quaternion.
  *
  * Tries to normalize the quaternion. If the length of the quaternion is too
@@ -0,0 +1,523 @@
+/*
+ * alglin_lanes.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+/* Lane-wise versions of the alglin.h functions, used by the lane-per-world
+ * kernel in dynamics/step_lanes.h. Every scalar is replaced by an array of
+ * TP_LANES scalars, one per world of a memory/interleaved.h block, and every
+ * function loops over the lanes. The loops have no branches, so that the
+ * compiler turns them into SIMD instructions.
+ */
+
+#ifndef TP_FUNC_LANES_INLINE
+#define TP_FUNC_LANES_INLINE TP_FUNC_INLINE
+#endif
+
+#ifndef TP_FUNC_LANES
+#define TP_FUNC_LANES TP_FUNC
+#endif
+
+// Loop over the lanes of a block, the lanes never depend on each other
+#if defined(__GNUC__) && !defined(__clang__)
+#define TP_FOR_LANES(L) _Pragma("GCC ivdep") for(int L = 0; L < (int)(TP_LANES); ++L)
+#else
+#define TP_FOR_LANES(L) for(int L = 0; L < (int)(TP_LANES); ++L)
+#endif
+
+/**
+ * One scalar for each world of a block.
+ * @ingroup tp-alglin
+ */
+typedef real_t tp_lanes[TP_LANES];
+
+/**
+ * The 3D vector type, for each world of a block.
+ * @ingroup tp-alglin
+ */
+typedef tp_lanes tp_vec3_lanes[3];
+
+/**
+ * The quaternion type, for each world of a block.
+ * @ingroup tp-alglin
+ */
+typedef tp_lanes tp_quatern_lanes[4];
+
+/**
+ * The 3x3 matrix type, for each world of a block. Elements are stored row
+ * by row without padding.
+ * @ingroup tp-alglin
+ */
+typedef tp_lanes tp_mtx33_lanes[9];
+
+/** Fetches a vector of every lane from memory.
+ *
+ * @param[in]		vec			Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ * @param[out]		copy		Vectors where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void get_vec3_lanes(const real_t *vec, tp_vec3_lanes copy)
+{
+	TP_FOR_LANES(l)
+	{
+		copy[0][l] = _x(vec + l);
+		copy[1][l] = _y(vec + l);
+		copy[2][l] = _z(vec + l);
+	}
+}
+
+/** Writes a vector of every lane to memory.
+ *
+ * @param[in]		new_vec		Vectors to be stored to memory.
+ * @param[out]		storage		Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void set_vec3_lanes(const tp_vec3_lanes new_vec, real_t *storage)
+{
+	TP_FOR_LANES(l)
+	{
+		*x(storage + l) = new_vec[0][l];
+		*y(storage + l) = new_vec[1][l];
+		*z(storage + l) = new_vec[2][l];
+	}
+}
+
+/** Fetches a quaternion of every lane from memory.
+ *
+ * @param[in]		quatern		Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ * @param[out]		copy		Quaternions where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void get_quatern_lanes(const real_t *quatern, tp_quatern_lanes copy)
+{
+	TP_FOR_LANES(l)
+	{
+		copy[0][l] = _q0(quatern + l);
+		copy[1][l] = _q1(quatern + l);
+		copy[2][l] = _q2(quatern + l);
+		copy[3][l] = _q3(quatern + l);
+	}
+}
+
+/** Writes a quaternion of every lane to memory.
+ *
+ * @param[in]		new_quatern		Quaternions to be stored to memory.
+ * @param[out]		storage			Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void set_quatern_lanes(const tp_quatern_lanes new_quatern, real_t *storage)
+{
+	TP_FOR_LANES(l)
+	{
+		*q0(storage + l) = new_quatern[0][l];
+		*q1(storage + l) = new_quatern[1][l];
+		*q2(storage + l) = new_quatern[2][l];
+		*q3(storage + l) = new_quatern[3][l];
+	}
+}
+
+/** Fetches a 3x3 matrix of every lane from memory.
+ *
+ * @param[in]		mtx			Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ * @param[out]		copy		Matrices where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void get_mtx33_lanes(const real_t *mtx, tp_mtx33_lanes copy)
+{
+	for(int k = 0; k < 9; ++k)
+	{
+		TP_FOR_LANES(l)
+			copy[k][l] = _ij(mtx + l, k/3, k%3);
+	}
+}
+
+/** Writes a 3x3 matrix of every lane to memory.
+ *
+ * @param[in]		new_mtx		Matrices to be stored to memory.
+ * @param[out]		storage		Pointer to the memory of lane 0, obtained by a memory abstraction function.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void set_mtx33_lanes(const tp_mtx33_lanes new_mtx, real_t *storage)
+{
+	for(int k = 0; k < 9; ++k)
+	{
+		TP_FOR_LANES(l)
+			*ij(storage + l, k/3, k%3) = new_mtx[k][l];
+	}
+}
+
+/** Checks if all lanes map to the same body.
+ *
+ * This is the case when the worlds of a block share the same model, which
+ * lets the gather and scatter functions below use contiguous loads and stores.
+ *
+ * @param[in]		body		Body index of every lane.
+ * @return @b true if all lanes map to the same body.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+bool same_body_lanes(const index_t *body)
+{
+	int differs = 0;
+	TP_FOR_LANES(l)
+		differs |= body[l] ^ body[0];
+	return differs == 0;
+}
+
+/** Fetches, for every lane, a scalar belonging to the body the lane maps to.
+ *
+ * The scalar of body @a b of lane @a l is found at @a base + @a b * @a stride + @a l,
+ * where @a base and @a stride are obtained from a memory abstraction function,
+ * e.g. mi(m, 0) and mi(m, 1) - mi(m, 0).
+ *
+ * @param[in]		base		Pointer to the scalar of body 0, lane 0.
+ * @param			stride		Distance between the scalars of two consecutive bodies.
+ * @param[in]		body		Body index of every lane.
+ * @param[out]		copy		Scalars where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void gather_lanes(const real_t *base, ptrdiff_t stride, const index_t *body, tp_lanes copy)
+{
+	if(same_body_lanes(body))
+	{
+		const real_t *storage = base + body[0]*stride;
+		TP_FOR_LANES(l)
+			copy[l] = storage[l];
+		return;
+	}
+
+	TP_FOR_LANES(l)
+		copy[l] = base[body[l]*stride + l];
+}
+
+/** Fetches, for every lane, a vector belonging to the body the lane maps to.
+ *
+ * Addressing is done as in gather_lanes(), e.g. with vel(m, 0) and
+ * vel(m, 1) - vel(m, 0).
+ *
+ * @param[in]		base		Pointer to the vector of body 0, lane 0.
+ * @param			stride		Distance between the vectors of two consecutive bodies.
+ * @param[in]		body		Body index of every lane.
+ * @param[out]		copy		Vectors where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void gather_vec3_lanes(const real_t *base, ptrdiff_t stride, const index_t *body, tp_vec3_lanes copy)
+{
+	if(same_body_lanes(body))
+	{
+		get_vec3_lanes(base + body[0]*stride, copy);
+		return;
+	}
+
+	TP_FOR_LANES(l)
+	{
+		const real_t *vec = base + body[l]*stride + l;
+		copy[0][l] = _x(vec);
+		copy[1][l] = _y(vec);
+		copy[2][l] = _z(vec);
+	}
+}
+
+/** Fetches, for every lane, a 3x3 matrix belonging to the body the lane maps to.
+ *
+ * Addressing is done as in gather_lanes().
+ *
+ * @param[in]		base		Pointer to the matrix of body 0, lane 0.
+ * @param			stride		Distance between the matrices of two consecutive bodies.
+ * @param[in]		body		Body index of every lane.
+ * @param[out]		copy		Matrices where to store the fetched memory.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void gather_mtx33_lanes(const real_t *base, ptrdiff_t stride, const index_t *body, tp_mtx33_lanes copy)
+{
+	if(same_body_lanes(body))
+	{
+		get_mtx33_lanes(base + body[0]*stride, copy);
+		return;
+	}
+
+	for(int k = 0; k < 9; ++k)
+	{
+		TP_FOR_LANES(l)
+			copy[k][l] = _ij(base + body[l]*stride + l, k/3, k%3);
+	}
+}
+
+/** Adds, for every lane, a scaled vector to a vector belonging to the body the
+ * lane maps to.
+ *
+ * Computes storage += @a mult * @a vec, addressing is done as in gather_lanes().
+ *
+ * @param[in]		vec			Vectors to add.
+ * @param[in]		mult		Multiplier for @a vec.
+ * @param[out]		base		Pointer to the vector of body 0, lane 0.
+ * @param			stride		Distance between the vectors of two consecutive bodies.
+ * @param[in]		body		Body index of every lane.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void scatter_add_vec3_lanes(
+		const tp_vec3_lanes vec,
+		const tp_lanes mult,
+		real_t *base,
+		ptrdiff_t stride,
+		const index_t *body)
+{
+	if(same_body_lanes(body))
+	{
+		real_t *storage = base + body[0]*stride;
+		TP_FOR_LANES(l)
+		{
+			*x(storage + l) += vec[0][l] * mult[l];
+			*y(storage + l) += vec[1][l] * mult[l];
+			*z(storage + l) += vec[2][l] * mult[l];
+		}
+		return;
+	}
+
+	TP_FOR_LANES(l)
+	{
+		real_t *storage = base + body[l]*stride + l;
+		*x(storage) += vec[0][l] * mult[l];
+		*y(storage) += vec[1][l] * mult[l];
+		*z(storage) += vec[2][l] * mult[l];
+	}
+}
+
+/** Computes the dot product of two 3D vectors, for every lane.
+ *
+ * @param[out]		result		The dot products.
+ * @param[in]		a			Input vectors a.
+ * @param[in]		b			Input vectors b.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void dot_vec3_lanes(tp_lanes result, const tp_vec3_lanes a, const tp_vec3_lanes b)
+{
+	TP_FOR_LANES(l)
+		result[l] = a[0][l] * b[0][l] + a[1][l] * b[1][l] + a[2][l] * b[2][l];
+}
+
+/** Scales a 3D vector, for every lane.
+ *
+ * @param[in,out]	vec			Input vectors.
+ * @param[in]		mult		Multiplier for each lane.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void scale_to_vec3_lanes(tp_vec3_lanes vec, const tp_lanes mult)
+{
+	TP_FOR_LANES(l)
+	{
+		vec[0][l] *= mult[l];
+		vec[1][l] *= mult[l];
+		vec[2][l] *= mult[l];
+	}
+}
+
+/** Computes the cross product of two 3D vectors, for every lane.
+ *
+ * @param[out]		result		The vectors to store the result in.
+ * @param[in]		a			Input vectors a.
+ * @param[in]		b			Input vectors b.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void cross_vec3_lanes(tp_vec3_lanes result, const tp_vec3_lanes a, const tp_vec3_lanes b)
+{
+	TP_FOR_LANES(l)
+	{
+		result[0][l] = a[1][l]*b[2][l] - b[1][l]*a[2][l];
+		result[1][l] = -a[0][l]*b[2][l] + b[0][l]*a[2][l];
+		result[2][l] = a[0][l]*b[1][l] - b[0][l]*a[1][l];
+	}
+}
+
+/** Multiplies a 3x1 vector by a 3x3 matrix, for every lane.
+ *
+ * @param[out]		result		The vectors to store the result in.
+ * @param[in]		mtx			Input matrices.
+ * @param[in]		vec			Input vectors.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void mult_mtx33_vec3_lanes(tp_vec3_lanes result, const tp_mtx33_lanes mtx, const tp_vec3_lanes vec)
+{
+	TP_FOR_LANES(l)
+	{
+		real_t v0 = vec[0][l], v1 = vec[1][l], v2 = vec[2][l];
+		result[0][l] = v0*mtx[0][l] + v1*mtx[1][l] + v2*mtx[2][l];
+		result[1][l] = v0*mtx[3][l] + v1*mtx[4][l] + v2*mtx[5][l];
+		result[2][l] = v0*mtx[6][l] + v1*mtx[7][l] + v2*mtx[8][l];
+	}
+}
+
+/** Multiplies a 3x1 vector by the transpose of a 3x3 matrix, for every lane.
+ *
+ * @param[out]		result		The vectors to store the result in.
+ * @param[in]		mtx			Input matrices.
+ * @param[in]		vec			Input vectors.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void mult_mtx33T_vec3_lanes(tp_vec3_lanes result, const tp_mtx33_lanes mtx, const tp_vec3_lanes vec)
+{
+	TP_FOR_LANES(l)
+	{
+		real_t v0 = vec[0][l], v1 = vec[1][l], v2 = vec[2][l];
+		result[0][l] = v0*mtx[0][l] + v1*mtx[3][l] + v2*mtx[6][l];
+		result[1][l] = v0*mtx[1][l] + v1*mtx[4][l] + v2*mtx[7][l];
+		result[2][l] = v0*mtx[2][l] + v1*mtx[5][l] + v2*mtx[8][l];
+	}
+}
+
+/** Multiplies a 3x3 matrix by a 3x3 matrix, for every lane.
+ *
+ * Multiplies matrix @a A by matrix @a B, result = AB.
+ *
+ * @param[out]		result			The matrices to store the result in.
+ * @param[in]		A				Input matrices A.
+ * @param[in]		B				Input matrices B.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void mult_mtx33_mtx33_lanes(tp_mtx33_lanes result, const tp_mtx33_lanes A, const tp_mtx33_lanes B)
+{
+	for(int r = 0; r < 3; ++r)
+	{
+		for(int c = 0; c < 3; ++c)
+		{
+			TP_FOR_LANES(l)
+				result[3*r+c][l] = B[c][l]*A[3*r][l] + B[3+c][l]*A[3*r+1][l] + B[6+c][l]*A[3*r+2][l];
+		}
+	}
+}
+
+/** Multiplies a 3x3 matrix by the transpose of a 3x3 matrix, for every lane.
+ *
+ * Multiplies matrix @a A by the transpose of matrix @a B, result = <em>AB</em>^T
+ *
+ * @param[out]		result			The matrices to store the result in.
+ * @param[in]		A				Input matrices A.
+ * @param[in]		B				Input matrices B.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void mult_mtx33_mtx33T_lanes(tp_mtx33_lanes result, const tp_mtx33_lanes A, const tp_mtx33_lanes B)
+{
+	for(int r = 0; r < 3; ++r)
+	{
+		for(int c = 0; c < 3; ++c)
+		{
+			TP_FOR_LANES(l)
+				result[3*r+c][l] = B[3*c][l]*A[3*r][l] + B[3*c+1][l]*A[3*r+1][l] + B[3*c+2][l]*A[3*r+2][l];
+		}
+	}
+}
+
+/** Converts a quaternion to a 3x3 rotation matrix, for every lane.
+ *
+ * @param[in]		q			Quaternions to convert.
+ * @param[out]		R			Matrices to store the result in.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void quaternion_to_rot_mtx33_lanes(const tp_quatern_lanes q, tp_mtx33_lanes R)
+{
+	TP_FOR_LANES(l)
+	{
+		real_t w = q[0][l], a = q[1][l], b = q[2][l], c = q[3][l];
+
+		R[0][l] = TP_REAL(1.0) - TP_REAL(2.0)*b*b - TP_REAL(2.0)*c*c;
+		R[1][l] = TP_REAL(2.0)*a*b - TP_REAL(2.0)*w*c;
+		R[2][l] = TP_REAL(2.0)*a*c + TP_REAL(2.0)*w*b;
+
+		R[3][l] = TP_REAL(2.0)*a*b + TP_REAL(2.0)*w*c;
+		R[4][l] = TP_REAL(1.0) - TP_REAL(2.0)*a*a - TP_REAL(2.0)*c*c;
+		R[5][l] = TP_REAL(2.0)*b*c - TP_REAL(2.0)*w*a;
+
+		R[6][l] = TP_REAL(2.0)*a*c - TP_REAL(2.0)*w*b;
+		R[7][l] = TP_REAL(2.0)*b*c + TP_REAL(2.0)*w*a;
+		R[8][l] = TP_REAL(1.0) - TP_REAL(2.0)*a*a - TP_REAL(2.0)*b*b;
+	}
+}
+
+/** Computes the product between the quaternion (0, @a omega) and a
+ * quaternion, for every lane. See mult_omega_quatern().
+ *
+ * @param[out]		result			The quaternions to store the result in.
+ * @param[in]		omega			Input vectors (angular velocity).
+ * @param[in]		q				Input quaternions.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void mult_omega_quatern_lanes(tp_quatern_lanes result, const tp_vec3_lanes omega, const tp_quatern_lanes q)
+{
+	TP_FOR_LANES(l)
+	{
+		real_t w0 = omega[0][l], w1 = omega[1][l], w2 = omega[2][l];
+		real_t a = q[1][l], b = q[2][l], c = q[3][l];
+
+		result[0][l] = -(w0 * a + w1 * b + w2 * c);
+		result[1][l] = w0*q[0][l] + TP_REAL(1.0)*(w1*c - b*w2);
+		result[2][l] = w1*q[0][l] + TP_REAL(1.0)*(-w0*c + a*w2);
+		result[3][l] = w2*q[0][l] + TP_REAL(1.0)*(w0*b - a*w1);
+	}
+}
+
+/** Normalizes a quaternion, for every lane.
+ *
+ * Quaternions whose length is too small are left unchanged, see normalize_quaternion().
+ *
+ * @param[in,out]	q			Input quaternions.
+ *
+ * @ingroup tp-alglin
+ */
+TP_FUNC_LANES_INLINE
+void normalize_quaternion_lanes(tp_quatern_lanes q)
+{
+	TP_FOR_LANES(l)
+	{
+		real_t magnitude2 = q[0][l]*q[0][l] + q[1][l]*q[1][l] + q[2][l]*q[2][l] + q[3][l]*q[3][l];
+		real_t magnitude = (magnitude2 < TP_REAL(1e-7)) ? TP_REAL(1.0) : TP_SQRT(magnitude2);
+		q[0][l] = q[0][l] / magnitude;
+		q[1][l] = q[1][l] / magnitude;
+		q[2][l] = q[2][l] / magnitude;
+		q[3][l] = q[3][l] / magnitude;
+	}
+}
@@ -0,0 +1,482 @@
+/*
+ * batch.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include "pool.h"
+
+/**
+ * Arguments to the step_worlds() job.
+ *
+ * @ingroup tp-batch
+ */
+struct step_job_t
+{
+	struct mem_t *worlds;
+	real_t dt;
+	int num_iterations;
+	real_t tolerance;
+};
+
+/** Steps a range of worlds, the task run by step_worlds().
+ *
+ * @param		data			Pointer to a step_job_t.
+ * @param		begin			First world to step.
+ * @param		end				One past the last world to step.
+ *
+ * @ingroup tp-batch
+ */
+inline void step_worlds_task(void *data, size_t begin, size_t end)
+{
+	struct step_job_t *job = (struct step_job_t *)data;
+
+	for(size_t w = begin; w < end; ++w)
+		step_world(job->worlds + w, job->dt, job->num_iterations, job->tolerance);
+}
+
+/** Steps a batch of independent simulation worlds a dt amount of seconds.
+ *
+ * The worlds are distributed over the threads of @a pool. Each world is
+ * stepped exactly as by step_world(), so the result does not depend on the
+ * number of threads. With the memory/interleaved.h layout the worlds should
+ * be the handles of whole blocks, in lane order.
+ *
+ * @param		pool			Pool to step the worlds on.
+ * @param		worlds			Array of the memory representing the worlds.
+ * @param		n				Number of worlds.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ *
+ * @ingroup tp-batch
+ */
+inline void step_worlds(
+		struct pool_t *pool,
+		struct mem_t *worlds,
+		size_t n,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+	struct step_job_t job;
+	job.worlds = worlds;
+	job.dt = dt;
+	job.num_iterations = num_iterations;
+	job.tolerance = tolerance;
+
+	size_t chunk = 0;
+
+#ifdef TP_LANES
+	// The lanes of a block share cache lines, keep each block on one thread
+	chunk = n / (8*pool->num_threads);
+	chunk = ((chunk + (TP_LANES) - 1)/(TP_LANES))*(TP_LANES);
+	if(chunk == 0) chunk = TP_LANES;
+#endif
+
+	run_pool(pool, step_worlds_task, (void *)&job, n, chunk);
+}
+
+/** Steps a batch of independent simulation worlds a dt amount of seconds,
+ * using the default pool.
+ *
+ * @param		worlds			Array of the memory representing the worlds.
+ * @param		n				Number of worlds.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ *
+ * @ingroup tp-batch
+ */
+inline void step_worlds(
+		struct mem_t *worlds,
+		size_t n,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+	step_worlds(default_pool(), worlds, n, dt, num_iterations, tolerance);
+}
+
+// The colouring has the size of the model, which is not known at compile time with TP_DYNAMIC
+#ifndef TP_DYNAMIC
+/**
+ * Colouring of the hinges of a world, for solving the rows of hinges of the same
+ * colour concurrently, see colour_hinges(). Hinges of the same colour do not share
+ * any body, so their rows write to different entries of \f$a\f$.
+ *
+ * @ingroup tp-batch
+ */
+struct colouring_t
+{
+	index_t rows[TP_HINGE_MOTOR_CONSTRAINTS];		// Hinge and motor rows, by colour and hinge
+	index_t unit_start[(TP_HINGES)+1];				// First row of each hinge in rows
+	index_t colour_start[(TP_HINGES)+1];			// First hinge of each colour
+	int num_colours;
+};
+
+/** Colours the hinges of a world greedily, so that hinges sharing a body get
+ * different colours.
+ *
+ * The colouring depends only on which bodies the hinges and motors connect, so
+ * it is computed once when the world has been configured, see create_hinge() and
+ * add_motor(). The rows of each hinge are followed by the rows of its motors.
+ *
+ * @param		m				Pointer to the memory representing the world.
+ * @param[out]	colouring		The colouring.
+ *
+ * @ingroup tp-batch
+ */
+inline void colour_hinges(struct mem_t *m, struct colouring_t *colouring)
+{
+	int colour[(TP_HINGES)+1];
+	colouring->num_colours = 0;
+
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		// Smallest colour not used by a hinge sharing a body
+		bool used[(TP_HINGES)+1];
+		for(int c = 0; c <= (TP_HINGES); ++c) used[c] = false;
+
+		for(int g = 0; g < h; ++g)
+		{
+			for(int bi = 0; bi < 2; ++bi)
+				for(int bj = 0; bj < 2; ++bj)
+					if(_Jm(m, 5*g, bj) == _Jm(m, 5*h, bi)) used[colour[g]] = true;
+		}
+
+		colour[h] = 0;
+		while(used[colour[h]]) ++colour[h];
+
+		if(colour[h] + 1 > colouring->num_colours)
+			colouring->num_colours = colour[h] + 1;
+	}
+
+	int num_units = 0, num_rows = 0;
+	for(int c = 0; c < colouring->num_colours; ++c)
+	{
+		colouring->colour_start[c] = num_units;
+
+		for(int h = 0; h < (TP_HINGES); ++h)
+		{
+			if(colour[h] != c) continue;
+
+			colouring->unit_start[num_units++] = num_rows;
+
+			for(int k = 0; k < 5; ++k)
+				colouring->rows[num_rows++] = 5*h + k;
+
+			for(int motor = 0; motor < (TP_MOTORS); ++motor)
+				if(_mm(m, motor) == h) colouring->rows[num_rows++] = TP_HINGE_CONSTRAINTS + motor;
+		}
+	}
+
+	colouring->colour_start[colouring->num_colours] = num_units;
+	colouring->unit_start[num_units] = num_rows;
+}
+
+/**
+ * A barrier for the threads of a parallel solve, spinning since the threads
+ * meet after every colour.
+ *
+ * @ingroup tp-batch
+ */
+struct spin_barrier_t
+{
+	volatile int count;
+	volatile int sense;
+	int num_threads;
+};
+
+/** Waits until all threads have reached the barrier.
+ *
+ * @param		barrier			The barrier.
+ * @param		local_sense		Sense of the calling thread, initially zero.
+ *
+ * @ingroup tp-batch
+ */
+inline void wait_barrier(struct spin_barrier_t *barrier, int *local_sense)
+{
+	*local_sense = !*local_sense;
+
+	if(__sync_add_and_fetch(&barrier->count, 1) == barrier->num_threads)
+	{
+		barrier->count = 0;
+		__sync_synchronize();
+		barrier->sense = *local_sense;
+	}
+	else
+	{
+		for(int spins = 1; barrier->sense != *local_sense; ++spins)
+			if(spins % 1024 == 0) sched_yield();
+	}
+
+	__sync_synchronize();
+}
+
+/**
+ * Arguments to the solve_for_lambda_parallel() job.
+ *
+ * @ingroup tp-batch
+ */
+struct solve_job_t
+{
+	struct mem_t *m;
+	const struct colouring_t *colouring;
+	int num_iterations;
+	real_t tolerance;
+	int iterations;
+
+	struct spin_barrier_t barrier;
+	double *max_delta;			// Per thread and iteration parity, the partials of the pool
+#ifdef TP_THREAD_WORK
+	struct work_t *work;		// Solver work memory of the calling thread
+#endif
+};
+
+/** Runs the sweeps of a parallel solve on one thread, the task run by
+ * solve_for_lambda_parallel().
+ *
+ * @param		data			Pointer to a solve_job_t.
+ * @param		begin			Index of the thread.
+ * @param		end				One past the index of the thread.
+ *
+ * @ingroup tp-batch
+ */
+inline void solve_for_lambda_task(void *data, size_t begin, size_t end)
+{
+	struct solve_job_t *job = (struct solve_job_t *)data;
+	struct mem_t *m = job->m;
+	const struct colouring_t *colouring = job->colouring;
+
+	const int t = (int)begin;
+	const int num_threads = job->barrier.num_threads;
+	int local_sense = 0;
+
+#ifdef TP_THREAD_WORK
+	// All threads solve on the quantities set up by the calling thread
+	struct work_t *own_work = use_work(job->work);
+#endif
+
+	int iterations = job->num_iterations;
+	for(int i = 0; i < job->num_iterations; ++i)
+	{
+		real_t max_delta = TP_REAL(0.0);
+
+		// Hinges of one colour share no bodies, split them over the threads
+		for(int c = 0; c < colouring->num_colours; ++c)
+		{
+			for(int u = colouring->colour_start[c] + t; u < colouring->colour_start[c+1]; u += num_threads)
+			{
+				for(int k = colouring->unit_start[u]; k < colouring->unit_start[u+1]; ++k)
+				{
+					real_t delta = solve_row(m, colouring->rows[k]);
+					if(delta > max_delta) max_delta = delta;
+				}
+			}
+
+			wait_barrier(&job->barrier, &local_sense);
+		}
+
+		// Contact rows, few and sharing the feet, on one thread
+		if(t == 0)
+		{
+			for(int r = TP_HINGE_MOTOR_CONSTRAINTS; r < num_active_rows(m); ++r)
+			{
+				real_t delta = solve_row(m, active_row(m, r));
+				if(delta > max_delta) max_delta = delta;
+			}
+		}
+
+		job->max_delta[(i % 2)*num_threads + t] = max_delta;
+		wait_barrier(&job->barrier, &local_sense);
+
+		// All threads see the same changes, and stop at the same iteration
+		for(int u = 0; u < num_threads; ++u)
+			if(job->max_delta[(i % 2)*num_threads + u] > max_delta)
+				max_delta = job->max_delta[(i % 2)*num_threads + u];
+
+		if(max_delta < job->tolerance)
+		{
+			iterations = i + 1;
+			break;
+		}
+	}
+
+	if(t == 0) job->iterations = iterations;
+
+#ifdef TP_THREAD_WORK
+	use_work(own_work);
+#endif
+}
+
+/** Solves for the Lagrange multipliers of one world on the threads of a pool.
+ *
+ * Each sweep solves the hinges colour by colour, the hinges of a colour
+ * concurrently, followed by the active contact rows. The rows are thus solved
+ * in another order than by solve_for_lambda(), but the result does not depend
+ * on the number of threads. The hinge rows are always solved one row at a time,
+ * also if #TP_BLOCK_HINGES or #TP_TREE_SOLVER is defined.
+ *
+ * The pool must not run any other job during the solve, since its threads
+ * wait for each other after every colour. With memory/shared.h the threads of
+ * the pool solve on the work memory of the calling thread, see use_work().
+ *
+ * @param		pool			Pool to solve on.
+ * @param		m				Pointer to the memory representing the world.
+ * @param		colouring		Colouring of the hinges of the world, see colour_hinges().
+ * @param		dt				Simulation timestep.
+ * @param		num_iterations	Maximum number of iterations.
+ * @param		tolerance		Convergence tolerance, see solve_for_lambda().
+ * @return the number of iterations run.
+ *
+ * @ingroup tp-batch
+ */
+inline int solve_for_lambda_parallel(
+		struct pool_t *pool,
+		struct mem_t *m,
+		const struct colouring_t *colouring,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+	setup_rows(m, dt);	// B = M^{-1}J^{T}, a = B\lambda_0, d = diag(JB), di = 1/d, rhs = 1/dt*e - 1/dt*Jv - M^{-1}F_e
+
+	struct solve_job_t job;
+	job.m = m;
+	job.colouring = colouring;
+	job.num_iterations = num_iterations;
+	job.tolerance = tolerance;
+	job.iterations = 0;
+	job.barrier.count = 0;
+	job.barrier.sense = 0;
+	job.barrier.num_threads = pool->num_threads;
+	job.max_delta = pool->partials;
+#ifdef TP_THREAD_WORK
+	job.work = work();
+#endif
+
+	// One item per thread, each thread claims exactly one
+	run_pool(pool, solve_for_lambda_task, (void *)&job, pool->num_threads, 1);
+
+	return job.iterations;
+}
+
+/** Steps a simulation world a dt amount of seconds, solving for the constraint
+ * forces on the threads of a pool, see solve_for_lambda_parallel().
+ *
+ * @param		pool			Pool to solve on.
+ * @param		m				Pointer to the memory representing the world.
+ * @param		colouring		Colouring of the hinges of the world, see colour_hinges().
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ * @return the number of solver iterations run.
+ *
+ * @ingroup tp-batch
+ */
+inline int step_world_parallel(
+		struct pool_t *pool,
+		struct mem_t *m,
+		const struct colouring_t *colouring,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+#ifdef TP_GYROSCOPIC
+	add_gyroscopic_torque(m, dt);
+#endif
+
+	update_jacobian(m);
+
+	int iterations = solve_for_lambda_parallel(pool, m, colouring, dt, num_iterations, tolerance);
+
+	integrate_world(m, dt);
+
+	return iterations;
+}
+#endif
+
+#ifdef TP_LANES
+/**
+ * Arguments to the step_blocks() job.
+ *
+ * @ingroup tp-batch
+ */
+struct step_blocks_job_t
+{
+	struct mem_block_t *blocks;
+	real_t dt;
+	int num_iterations;
+	real_t tolerance;
+};
+
+/** Steps a range of blocks, the task run by step_blocks().
+ *
+ * @param		data			Pointer to a step_blocks_job_t.
+ * @param		begin			First block to step.
+ * @param		end				One past the last block to step.
+ *
+ * @ingroup tp-batch
+ */
+inline void step_blocks_task(void *data, size_t begin, size_t end)
+{
+	struct step_blocks_job_t *job = (struct step_blocks_job_t *)data;
+
+	for(size_t b = begin; b < end; ++b)
+		step_block(job->blocks + b, job->dt, job->num_iterations, job->tolerance);
+}
+
+/** Steps a batch of blocks of independent simulation worlds a dt amount of
+ * seconds, using the lane-per-world kernel step_block().
+ *
+ * @param		pool			Pool to step the blocks on.
+ * @param		blocks			Array of blocks, each holding #TP_LANES worlds.
+ * @param		n				Number of blocks.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ *
+ * @ingroup tp-batch
+ */
+inline void step_blocks(
+		struct pool_t *pool,
+		struct mem_block_t *blocks,
+		size_t n,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+	struct step_blocks_job_t job;
+	job.blocks = blocks;
+	job.dt = dt;
+	job.num_iterations = num_iterations;
+	job.tolerance = tolerance;
+
+	run_pool(pool, step_blocks_task, (void *)&job, n);
+}
+
+/** Steps a batch of blocks of independent simulation worlds a dt amount of
+ * seconds, using the default pool.
+ *
+ * @param		blocks			Array of blocks, each holding #TP_LANES worlds.
+ * @param		n				Number of blocks.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ *
+ * @ingroup tp-batch
+ */
+inline void step_blocks(
+		struct mem_block_t *blocks,
+		size_t n,
+		real_t dt,
+		int num_iterations,
+		real_t tolerance = TP_REAL(0.0))
+{
+	step_blocks(default_pool(), blocks, n, dt, num_iterations, tolerance);
+}
+#endif
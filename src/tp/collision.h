@@ -18,12 +18,14 @@ real_t get_terrain_height(const tp_vec3 pos)
 /**
  * Collides a body as a cylindrical foot against the terrain. The body position
  * is considered to be geometrical center of the cylinder. If a collision is
- * detected necessary constraints are added to the Jacobian.
+ * detected necessary constraints are added to the Jacobian, and marked as
+ * active, see activate_contact_row(). These are a normal row for each of the three
+ * contact points, and two tangent rows if #TP_CONTACT_TANGENTS is defined.
  *
  * @param		m				Pointer to the memory representing the simulation world.
  * @param		cyl_radius		Radius of the cylinder.
  * @param		cyl_height		Height of the cylinder.
- * @param		contacts_offset	Offset for the contact constraints rows in the Jacobian matrix.
+ * @param		contacts_offset	Offset for the contact constraints rows in the Jacobian matrix, a multiple of #TP_CONTACT_CONSTRAINTS.
  * @param		foot_body		Index for body to collide as foot, in the interval [0, #TP_BODIES-1].
  * @return Number of constraint rows added.
  *
@@ -111,6 +113,8 @@ int collide_foot_cylinder_tri(
 		*z(aJ(m, s+cpoint, 1)) = cxn[2];
 
 		*lambda_min(m, s+cpoint) = TP_REAL(0.0);
+
+		activate_contact_row(m, s+cpoint);
 	}
 
 
@@ -129,24 +133,28 @@ int collide_foot_cylinder_tri(
 	contact_tangent[1][2] = TP_REAL(0.0);
 	mult_to_mtx33_vec3(_R, contact_tangent[1]);
 
-//	for(int t = 0; t < 2; ++t)
-//	{
-//		*Jm(m, s+3+t, 0) 	= -1;
-//		*Jm(m, s+3+t, 1) 	= foot_body;
-//
-//		*x(tJ(m, s+3+t, 1)) = contact_tangent[t][0];
-//		*y(tJ(m, s+3+t, 1)) = contact_tangent[t][1];
-//		*z(tJ(m, s+3+t, 1)) = contact_tangent[t][2];
-//
-//		/* The next constraint makes the mass center of the foot not move
-//		 * in the tangent directions if there is contact, it should
-//		 * really be a touching point, but since feet are flat, this
-//		 * saves a cross product
-//		 */
-//		*x(aJ(m, s+3+t, 1)) = 0.0;
-//		*y(aJ(m, s+3+t, 1)) = 0.0;
-//		*z(aJ(m, s+3+t, 1)) = 0.0;
-//	}
+#ifdef TP_CONTACT_TANGENTS
+	for(int t = 0; t < 2; ++t)
+	{
+		*Jm(m, s+3+t, 0) 	= -1;
+		*Jm(m, s+3+t, 1) 	= foot_body;
+
+		*x(tJ(m, s+3+t, 1)) = contact_tangent[t][0];
+		*y(tJ(m, s+3+t, 1)) = contact_tangent[t][1];
+		*z(tJ(m, s+3+t, 1)) = contact_tangent[t][2];
+
+		/* The next constraint makes the mass center of the foot not move
+		 * in the tangent directions if there is contact, it should
+		 * really be a touching point, but since feet are flat, this
+		 * saves a cross product
+		 */
+		*x(aJ(m, s+3+t, 1)) = 0.0;
+		*y(aJ(m, s+3+t, 1)) = 0.0;
+		*z(aJ(m, s+3+t, 1)) = 0.0;
+
+		activate_contact_row(m, s+3+t);
+	}
+#endif
 
 
 #ifdef TP_DEBUG
@@ -164,7 +172,7 @@ int collide_foot_cylinder_tri(
 	set_vec3(contact_tangent[1], cpl1(m, num_contact));
 #endif
 
-	return 5;
+	return TP_CONTACT_CONSTRAINTS;
 }
 
 /*
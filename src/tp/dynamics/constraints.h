@@ -2,6 +2,142 @@
 #pragma once
 
 
+/** Marks a contact row of the Jacobian as active for the current step.
+ *
+ * Contact rows that are not active are skipped by the constraint solver, and must
+ * have zero Jacobian entries. The list of active rows is cleared at the end of
+ * step_world(), after zeroing the rows. Activating a row that is already active
+ * has no effect.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		constraint		Index of the contact row, in interval [#TP_HINGE_MOTOR_CONSTRAINTS, #TP_CONSTRAINTS-1].
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+void activate_contact_row(struct mem_t *m, index_t constraint)
+{
+	for(int r = 0; r < _ncrows(m); ++r)
+		if(_crow(m, r) == constraint) return;
+
+	assert(_ncrows(m) < TP_CONTACT_CONSTRAINTS*(TP_FEET));
+
+	*crow(m, _ncrows(m)) = constraint;
+	*ncrows(m) += 1;
+}
+
+/** Returns the number of rows processed by the constraint solver, the hinge and
+ * motor rows followed by the active contact rows.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @return the number of active rows.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+int num_active_rows(struct mem_t *m)
+{
+	return TP_HINGE_MOTOR_CONSTRAINTS + _ncrows(m);
+}
+
+/** Maps a position in the list of active rows to a constraint index.
+ *
+ * The hinge and motor rows are taken in the order of the row order table, see
+ * order_rows().
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		row				Position in interval [0, num_active_rows()-1].
+ * @return the constraint index of the row.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+index_t active_row(struct mem_t *m, int row)
+{
+	return (row < TP_HINGE_MOTOR_CONSTRAINTS) ? _rorder(m, row) : _crow(m, row - TP_HINGE_MOTOR_CONSTRAINTS);
+}
+
+/** Returns the type of a constraint row, which selects its relaxation factor.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		constraint		Index of the row, in interval [0, #TP_CONSTRAINTS-1].
+ * @return #TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+index_t relax_type(struct mem_t *m, index_t constraint)
+{
+	if(constraint < TP_HINGE_CONSTRAINTS) return TP_RELAX_HINGE;
+	if(constraint < TP_HINGE_MOTOR_CONSTRAINTS) return TP_RELAX_MOTOR;
+	return TP_RELAX_CONTACT;
+}
+
+/** Returns a memory pointer to an entry of a vector in the memory of the world.
+ *
+ * @param		vec3		Pointer to the vector, e.g. from ta().
+ * @param		k			0, 1 or 2 for the x, y or z entry.
+ * @return pointer to the entry.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+real_t * vec3_entry(real_t *vec3, int k)
+{
+	return (k == 0) ? x(vec3) : (k == 1) ? y(vec3) : z(vec3);
+}
+
+/** Gets the translational part of a Jacobian row.
+ *
+ * The translational parts of the hinge rows are constant, \f$\pm e_k\f$ for the three
+ * anchor rows and zero for the two axis rows, and zero for the motor rows. If
+ * #TP_COMPACT_JACOBIAN is defined they are not stored, and are constructed here.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		constraint	Index of the row, in interval [0, #TP_CONSTRAINTS-1].
+ * @param		body_index	0 or 1, first or second body.
+ * @param[out]	_tJ			Translational part of the row.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+void get_row_tJ(struct mem_t *m, index_t constraint, index_t body_index, tp_vec3 _tJ)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	if(constraint < TP_HINGE_MOTOR_CONSTRAINTS)
+	{
+		_tJ[0] = _tJ[1] = _tJ[2] = TP_REAL(0.0);
+		if(constraint < TP_HINGE_CONSTRAINTS && constraint % 5 < 3)
+			_tJ[constraint % 5] = body_index ? TP_REAL(-1.0) : TP_REAL(1.0);
+		return;
+	}
+#endif
+	get_vec3(tJ(m, constraint, body_index), _tJ);
+}
+
+/** Gets the translational part of a \f$B\f$ column, see get_row_tJ() and compute_B().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		constraint	Index of the row, in interval [0, #TP_CONSTRAINTS-1].
+ * @param		body_index	0 or 1, first or second body.
+ * @param[out]	_tB			Translational part of the column.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+void get_row_tB(struct mem_t *m, index_t constraint, index_t body_index, tp_vec3 _tB)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	if(constraint < TP_HINGE_MOTOR_CONSTRAINTS)
+	{
+		get_row_tJ(m, constraint, body_index, _tB);
+		scale_to_vec3(_tB, _mi(m, _Jm(m, constraint, body_index)));
+		return;
+	}
+#endif
+	get_vec3(tB(m, constraint, body_index), _tB);
+}
+
 /** Configures a motor for a hinge joint.
  *
  * @param		m			Pointer to the memory representing the simulation world.
@@ -46,6 +182,74 @@ void add_motor(
 	set_quatern(dq, iniquatern(m, hinge));
 }
 
+#ifdef TP_TREE_SOLVER
+/** Orders the bodies and hinges for the tree solver, see factor_tree().
+ *
+ * The bodies and hinges are the nodes of a graph with an edge between every hinge
+ * and its two bodies. The nodes are ordered breadth first, with each tree rooted
+ * at its lowest body, so that parents come before children. The order depends only
+ * on which bodies the hinges connect, and is updated by create_hinge(). If the
+ * hinges form a loop the first node of the order is set to -1.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @return @b true if successful, @b false if the hinges form a loop.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+bool order_tree(struct mem_t *m)
+{
+	bool visited[(TP_BODIES)+(TP_HINGES)];
+	for(int i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) visited[i] = false;
+
+	int num_ordered = 0;
+	for(int root = 0; root < (TP_BODIES); ++root)
+	{
+		if(visited[root]) continue;
+
+		visited[root] = true;
+		*tparent(m, root) = -1;
+		*tnode(m, num_ordered++) = root;
+
+		for(int q = num_ordered-1; q < num_ordered; ++q)
+		{
+			int i = _tnode(m, q);
+
+			if(i < (TP_BODIES))
+			{
+				for(int h = 0; h < (TP_HINGES); ++h)
+				{
+					int node = (TP_BODIES) + h;
+					if(visited[node]) continue;
+					if(_Jm(m, 5*h, 0) != i && _Jm(m, 5*h, 1) != i) continue;
+
+					visited[node] = true;
+					*tparent(m, node) = i;
+					*tnode(m, num_ordered++) = node;
+				}
+			}
+			else
+			{
+				int h = i - (TP_BODIES);
+				int body = (_Jm(m, 5*h, 0) == _tparent(m, i)) ? _Jm(m, 5*h, 1) : _Jm(m, 5*h, 0);
+
+				if(visited[body])
+				{
+					*tnode(m, 0) = -1;
+					return false;
+				}
+
+				visited[body] = true;
+				*tparent(m, body) = i;
+				*tnode(m, num_ordered++) = body;
+			}
+		}
+	}
+
+	return true;
+}
+#endif
+
 /** Configures a hinge joint between two bodies.
  *
  * @param		m					Pointer to the memory representing the simulation world.
@@ -55,6 +259,9 @@ void add_motor(
  * @param		anchor_world_coord	Hinge anchor in world coordinates.
  * @param		axis_world_coord	Direction of hinge axis in world coordinates.
  *
+ * If #TP_TREE_SOLVER is defined, the order of the tree solver is updated, see
+ * order_tree().
+ *
  * @ingroup tp-dynamics
  */
 TP_FUNC
@@ -128,6 +335,7 @@ void create_hinge(
 	cross_vec3(t1, t0, axis);
 	set_vec3(t1, ht1(m, hinge_num));
 
+#ifndef TP_COMPACT_JACOBIAN
 	// Add constant translational parts to Jacobian -----------------
 	*x(tJ(m, 5*hinge_num, 0)) 		= TP_REAL(1.0);
 	*y(tJ(m, 5*hinge_num+1, 0))		= TP_REAL(1.0);
@@ -136,6 +344,11 @@ void create_hinge(
 	*x(tJ(m, 5*hinge_num, 1)) 		= TP_REAL(-1.0);
 	*y(tJ(m, 5*hinge_num+1, 1)) 	= TP_REAL(-1.0);
 	*z(tJ(m, 5*hinge_num+2, 1)) 	= TP_REAL(-1.0);
+#endif
+
+#ifdef TP_TREE_SOLVER
+	order_tree(m);
+#endif
 }
 
 /** Updates the Jacobian after a timestep.
@@ -143,7 +356,8 @@ void create_hinge(
  * Every time when the simulation has been progressed one timestep, positions
  * and velocities of the bodies has (most likely) changed. Because of this the
  * Jacobian entries for the constraining joints are old and need to be updated.
- * This functions does exactly that.
+ * This functions does exactly that. The world frame anchors and axes are read
+ * from the kinematics cache, see update_kinematics().
  *
  * @param		m			Pointer to the memory representing the simulation world.
  *
@@ -158,17 +372,7 @@ void update_jacobian(struct mem_t *m)
 		tp_vec3 anchors_world[2];
 
 		for(int b = 0; b < 2; ++b)
-		{
-			index_t body = _Jm(m, 5*h, b);
-
-			tp_mtx33 _R;
-			get_mtx33(R(m, body), _R);
-
-			tp_vec3 anchor_local;
-			get_vec3(hanchor(m, h, b), anchor_local);
-
-			mult_mtx33_vec3(anchors_world[b], _R, anchor_local);
-		}
+			get_vec3(hanchor_world(m, h, b), anchors_world[b]);
 
 		// Body 0
 		/*          x    y      z
@@ -237,15 +441,10 @@ void update_jacobian(struct mem_t *m)
 	for(int s = TP_HINGE_CONSTRAINTS, motor = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s, ++motor)
 	{
 		index_t hinge = _mm(m, motor);
-		index_t hinge_body = _Jm(m, s, 0);
 
+		// The axis of the first body of the hinge, in world coords
 		tp_vec3 axis;
-		get_vec3(haxis(m, hinge), axis);
-
-		tp_mtx33 _R;
-		get_mtx33(R(m, hinge_body), _R);
-
-		mult_to_mtx33_vec3(_R, axis);
+		get_vec3(haxis_world(m, hinge, 0), axis);
 
 		*x(aJ(m, s, 0)) = -axis[0];
 		*y(aJ(m, s, 0)) = -axis[1];
@@ -256,3 +455,96 @@ void update_jacobian(struct mem_t *m)
 		*z(aJ(m, s, 1)) = axis[2];
 	}
 }
+
+/** Orders the hinge and motor rows of the solver sweep from the leaves to the roots.
+ *
+ * The bodies and hinges form a graph, see \ref tp-dynamics. The depth of a body is
+ * its number of hinges from the closest root body, and the depth of a hinge the
+ * largest depth of its two bodies. Bodies not connected to a root are measured from
+ * their lowest connected body. The hinges are then solved by decreasing depth, the
+ * five rows of a hinge together, followed by the motors by decreasing depth of their
+ * hinges. Hinges of equal depth keep their index order.
+ *
+ * With the feet as roots, the forward sweeps go down the legs to the contacts, and
+ * with #TP_SYMMETRIC_SWEEPS defined the backward sweeps start at the contacts and
+ * carry the ground reaction forces up the legs. Call after creating the hinges and
+ * motors.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		roots			Root bodies, typically the bodies of the feet.
+ * @param		num_roots		Number of root bodies.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void order_rows(struct mem_t *m, const index_t *roots, int num_roots)
+{
+	TP_SCRATCH_ARRAY(int, depth, TP_BODIES);
+	for(int b = 0; b < (TP_BODIES); ++b) depth[b] = -1;
+
+	// Breadth first from the roots, then from any body not reached
+	TP_SCRATCH_ARRAY(index_t, queue, TP_BODIES);
+	int head = 0, queued = 0;
+
+	for(int r = 0; r < num_roots + (TP_BODIES); ++r)
+	{
+		index_t root = (r < num_roots) ? roots[r] : r - num_roots;
+		if(depth[root] < 0)
+		{
+			depth[root] = 0;
+			queue[queued++] = root;
+		}
+
+		// All roots are queued before traversing
+		if(r < num_roots - 1) continue;
+
+		for(; head < queued; ++head)
+		{
+			index_t b = queue[head];
+
+			for(int h = 0; h < (TP_HINGES); ++h)
+			{
+				index_t b0 = _Jm(m, 5*h, 0), b1 = _Jm(m, 5*h, 1);
+				index_t other = (b0 == b) ? b1 : (b1 == b) ? b0 : -1;
+
+				if(other < 0 || depth[other] >= 0) continue;
+
+				depth[other] = depth[b] + 1;
+				queue[queued++] = other;
+			}
+		}
+	}
+
+	TP_SCRATCH_ARRAY(int, hdepth, (TP_HINGES) + 1);
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		int d0 = depth[_Jm(m, 5*h, 0)], d1 = depth[_Jm(m, 5*h, 1)];
+		hdepth[h] = (d0 > d1) ? d0 : d1;
+	}
+
+	// Stable insertion sort by decreasing depth
+	TP_SCRATCH_ARRAY(index_t, hinges, (TP_HINGES) + 1);
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		int i = h;
+		for(; i > 0 && hdepth[hinges[i-1]] < hdepth[h]; --i) hinges[i] = hinges[i-1];
+		hinges[i] = h;
+	}
+
+	TP_SCRATCH_ARRAY(index_t, motors, (TP_MOTORS) + 1);
+	for(int k = 0; k < (TP_MOTORS); ++k)
+	{
+		int i = k;
+		for(; i > 0 && hdepth[_mm(m, motors[i-1])] < hdepth[_mm(m, k)]; --i) motors[i] = motors[i-1];
+		motors[i] = k;
+	}
+
+	for(int i = 0; i < (TP_HINGES); ++i)
+		for(int k = 0; k < 5; ++k)
+			*rorder(m, 5*i + k) = 5*hinges[i] + k;
+
+	for(int i = 0; i < (TP_MOTORS); ++i)
+		*rorder(m, TP_HINGE_CONSTRAINTS + i) = TP_HINGE_CONSTRAINTS + motors[i];
+
+	TP_RELEASE_SCRATCH(depth);
+}
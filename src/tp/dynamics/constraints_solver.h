@@ -17,6 +17,14 @@
  * \f$a = B\lambda_0\f$, \f$B=M^{-1}J^{\mathrm{T}}\f$, \f$d\f$ is the diagonal of \f$JB\f$
  * and \f$rhs\f$ is the right hand side.
  *
+ * Each step is scaled by a relaxation factor \f$\omega\f$ per type of row, hinge, motor
+ * or contact, which makes it Projected Successive Over-Relaxation. The factors
+ * default to 1, the plain Projected Gauss-Seidel above, see relax().
+ *
+ * Only the hinge and motor rows and the active contact rows are processed, see
+ * activate_contact_row(). Contact rows of feet that are not touching the ground
+ * cost nothing.
+ *
  */
 //@{
 
@@ -31,37 +39,36 @@
 TP_FUNC
 void compute_B(struct mem_t *m)
 {
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
 		for(int bi = 1; bi >= stop_at_body; --bi)
 		{
 			index_t body = _Jm(m, s, bi);
 
-			// Scale the translational components by 1/m = mi
-			tp_vec3 _tJ;
-			get_vec3(tJ(m, s, bi), _tJ);
-			scale_to_vec3(_tJ, _mi(m, body));
-			set_vec3(_tJ, tB(m, s, bi));
+			// Scale the translational components by 1/m = mi, constant for
+			// hinges and motors with a compact Jacobian, see get_row_tB()
+#ifdef TP_COMPACT_JACOBIAN
+			if(s >= TP_HINGE_MOTOR_CONSTRAINTS)
+#endif
+			{
+				tp_vec3 _tJ;
+				get_vec3(tJ(m, s, bi), _tJ);
+				scale_to_vec3(_tJ, _mi(m, body));
+				set_vec3(_tJ, tB(m, s, bi));
+			}
 
 			// Set the rotational components to (Iwi = R*Ibi*Rt) * rotational components
-			tp_mtx33 _Ibi;
-			get_mtx33(Ibi(m, body), _Ibi);
-
-			tp_mtx33 _R;
-			get_mtx33(R(m, body), _R);
-
-			tp_mtx33 IbiRT;
-			mult_mtx33_mtx33T(IbiRT, _Ibi, _R);
-
-			tp_mtx33 Ii;
-			mult_mtx33_mtx33(Ii, _R, IbiRT);
+			tp_mtx33 _Iwi;
+			get_mtx33(Iwi(m, body), _Iwi);
 
 			tp_vec3 _aJ;
 			get_vec3(aJ(m, s, bi), _aJ);
 
-			mult_to_mtx33_vec3(Ii, _aJ);
+			mult_to_mtx33_vec3(_Iwi, _aJ);
 			set_vec3(_aJ, aB(m, s, bi));
 		}
 	}
@@ -94,8 +101,10 @@ void compute_a(struct mem_t *m)
 	}
 
 	// First hinges (fixed) and motors (fixed)
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
 		for(int bi = 1; bi >= stop_at_body; --bi)
@@ -103,7 +112,7 @@ void compute_a(struct mem_t *m)
 			index_t body = _Jm(m, s, bi);
 
 			tp_vec3 _tB;
-			get_vec3(tB(m, s, bi), _tB);
+			get_row_tB(m, s, bi, _tB);
 			scale_to_vec3(_tB, _lambda(m, s));
 
 			*x(ta(m, body)) += _tB[0];
@@ -137,8 +146,10 @@ void compute_Fc_add_to_Fe(struct mem_t *m)
 	// F_c = J_T\lambda, add Fc to Fe
 
 	// First hinges and motors (fixed number)
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
 		for(int bi = 1; bi >= stop_at_body; --bi)
@@ -146,7 +157,7 @@ void compute_Fc_add_to_Fe(struct mem_t *m)
 			index_t body = _Jm(m, s, bi);
 
 			tp_vec3 _tJ;
-			get_vec3(tJ(m, s, bi), _tJ);
+			get_row_tJ(m, s, bi, _tJ);
 			scale_to_vec3(_tJ, _lambda(m, s));
 
 			*x(tFe(m, body)) += _tJ[0];
@@ -180,11 +191,18 @@ void compute_Fc(struct mem_t *m)
 {
 	// F_c = J_T\lambda, add Fc to Fe
 
-	for(int i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) m->Fc[i] = TP_REAL(0.0);
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		tp_vec3 zero = {0.0, 0.0, 0.0};
+		set_vec3(zero, tFc(m, b));
+		set_vec3(zero, aFc(m, b));
+	}
 
 	// First hinges and motors (fixed number)
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
 		for(int bi = 1; bi >= stop_at_body; --bi)
@@ -192,7 +210,7 @@ void compute_Fc(struct mem_t *m)
 			index_t body = _Jm(m, s, bi);
 
 			tp_vec3 _tJ;
-			get_vec3(tJ(m, s, bi), _tJ);
+			get_row_tJ(m, s, bi, _tJ);
 			scale_to_vec3(_tJ, _lambda(m, s));
 
 			*x(tFc(m, body)) += _tJ[0];
@@ -222,8 +240,10 @@ void compute_Fc(struct mem_t *m)
 TP_FUNC
 void compute_d(struct mem_t *m)
 {
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
 		real_t dii = TP_REAL(0.0);
@@ -231,8 +251,8 @@ void compute_d(struct mem_t *m)
 		for(int bi = 1; bi >= stop_at_body; --bi)
 		{
 			tp_vec3 _tJ, _tB;
-			get_vec3(tJ(m, s, bi), _tJ);
-			get_vec3(tB(m, s, bi), _tB);
+			get_row_tJ(m, s, bi, _tJ);
+			get_row_tB(m, s, bi, _tB);
 			dii += dot_vec3(_tJ, _tB);
 
 			tp_vec3 _aJ, _aB;
@@ -245,10 +265,68 @@ void compute_d(struct mem_t *m)
 	}
 }
 
+/** Adds the hinge error and the desired motor speeds to \f$rhs\f$, the part of
+ * compute_rhs() that does not depend on \f$J\f$.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		dt			Simulation timestep.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void add_error_to_rhs(struct mem_t *m, real_t dt)
+{
+	// Error correction for hinges, by project_positions() after the step if TP_POST_STABILIZATION is defined
+#ifndef TP_POST_STABILIZATION
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		tp_vec3 anchors_world[2];
+
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_vec3 _pos, _anchor;
+			get_vec3(pos(m, _Jm(m, 5*h, i)), _pos);
+			get_vec3(hanchor_world(m, h, i), _anchor);
+
+			add_vec3(anchors_world[i], _pos, _anchor, TP_REAL(1.0));
+		}
+
+		tp_vec3 error;
+		add_vec3(error, anchors_world[1], anchors_world[0], TP_REAL(-1.0));
+
+		*rhs(m, 5*h) 	+= (TP_ERP)/dt * error[0];
+		*rhs(m, 5*h+1) 	+= (TP_ERP)/dt * error[1];
+		*rhs(m, 5*h+2) 	+= (TP_ERP)/dt * error[2];
+
+		// Axis rotation error, in world coords
+		tp_vec3 axis_world_0, axis_world_1;
+		get_vec3(haxis_world(m, h, 0), axis_world_0);
+		get_vec3(haxis_world(m, h, 1), axis_world_1);
+
+		tp_vec3 u;
+		cross_vec3(u, axis_world_0, axis_world_1);
+
+		// The tangent base in world coords, as set up by update_jacobian()
+		tp_vec3 t0, t1;
+		get_vec3(aJ(m, 5*h+3, 0), t0);
+		get_vec3(aJ(m, 5*h+4, 0), t1);
+
+		*rhs(m, 5*h+3) += (TP_ERP)/dt * dot_vec3(t0, u);
+		*rhs(m, 5*h+4) += (TP_ERP)/dt * dot_vec3(t1, u);
+	}
+#endif
+
+	// Add desired motor speed for the motor constraints
+	for(int s = TP_HINGE_CONSTRAINTS, motor = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s, ++motor)
+		*rhs(m, s) += _mds(m, motor)/dt;
+}
+
 /** Computes the \f$rhs\f$ vector.
  *
  * Computes \f$rhs = \frac{1}{\Delta t}\epsilon - \frac{1}{\Delta t}Ju - JM^{-1}F_e\f$.
  * Here \f$u\f$ represents the system velocity vector, and \f$F_e\f$ the external forces.
+ * The hinge error \f$\epsilon\f$ is scaled by #TP_ERP, and left out if
+ * #TP_POST_STABILIZATION is defined, see project_positions().
  *
  * @param		m			Pointer to the memory representing the simulation world.
  * @param		dt			Simulation timestep.
@@ -259,8 +337,10 @@ TP_FUNC
 void compute_rhs(struct mem_t *m, real_t dt)
 {
 	// rhs = \frac{1}{\Delta t}\epsilon - \frac{1}{\Delta t}JV - JM^{-1}F_e
-	for(int s = 0; s < TP_CONSTRAINTS; ++s)
+	for(int r = 0; r < num_active_rows(m); ++r)
 	{
+		index_t s = active_row(m, r);
+
 		real_t JV = TP_REAL(0.0), JMiFe = TP_REAL(0.0);
 
 		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
@@ -270,7 +350,7 @@ void compute_rhs(struct mem_t *m, real_t dt)
 			index_t body = _Jm(m, s, bi);
 
 			tp_vec3 _tJ;
-			get_vec3(tJ(m, s, bi), _tJ);
+			get_row_tJ(m, s, bi, _tJ);
 
 			tp_vec3 _vel;
 			get_vec3(vel(m, body), _vel);
@@ -291,19 +371,10 @@ void compute_rhs(struct mem_t *m, real_t dt)
 			tp_vec3 _aFe;
 			get_vec3(aFe(m, body), _aFe);
 
-			tp_mtx33 _Ibi;
-			get_mtx33(Ibi(m, body), _Ibi);
+			tp_mtx33 _Iwi;
+			get_mtx33(Iwi(m, body), _Iwi);
 
-			tp_mtx33 _R;
-			get_mtx33(R(m, body), _R);
-
-			tp_mtx33 IbiRT;
-			mult_mtx33_mtx33T(IbiRT, _Ibi, _R);
-
-			tp_mtx33 Ii;
-			mult_mtx33_mtx33(Ii, _R, IbiRT);
-
-			mult_to_mtx33_vec3(Ii, _aFe);
+			mult_to_mtx33_vec3(_Iwi, _aFe);
 
 			// JM^{-1}Fe (translational) + (rotational)
 			JMiFe += dot_vec3(_tJ, _tFe) + dot_vec3(_aJ, _aFe);
@@ -312,69 +383,103 @@ void compute_rhs(struct mem_t *m, real_t dt)
 		*rhs(m, s) = -(TP_REAL(1.0)/dt) * JV - JMiFe;
 	}
 
-	// Error correction for hinges
-	for(int h = 0; h < (TP_HINGES); ++h)
+	add_error_to_rhs(m, dt);
+}
+
+/** Computes \f$B\f$, \f$a\f$, \f$d\f$ and \f$rhs\f$ in one pass over the active rows.
+ *
+ * Gives the same result as compute_B(), compute_a(), compute_d() and compute_rhs()
+ * in turn, but each row of \f$J\f$ and the inertia of its bodies are read once, and
+ * \f$M^{-1}F_e\f$ is computed once per body. The inverse \f$d_i^{-1}\f$ is stored as
+ * well, so the sweeps multiply instead of divide. \f$d_i^{-1}\f$ is zero for rows with \f$|d_i| \leq 10^{-7}\f$, which the
+ * solver then leaves unchanged, see solve_row_type().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		dt			Simulation timestep.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void setup_rows(struct mem_t *m, real_t dt)
+{
+	// M^{-1}F_e of every body, shared by its rows, and a zeroed
+	TP_SCRATCH_ARRAY(tp_vec3, tMiFe, TP_BODIES);
+	TP_SCRATCH_ARRAY(tp_vec3, aMiFe, TP_BODIES);
+	for(int b = 0; b < (TP_BODIES); ++b)
 	{
-		tp_vec3 anchors_world[2];
+		get_vec3(tFe(m, b), tMiFe[b]);
+		scale_to_vec3(tMiFe[b], _mi(m, b));
 
-		for(int i = 0; i < 2; ++i)
-		{
-			index_t body = _Jm(m, 5*h, i);
+		tp_mtx33 _Iwi;
+		get_mtx33(Iwi(m, b), _Iwi);
 
-			tp_mtx33 _R;
-			get_mtx33(R(m, _Jm(m, 5*h, i)), _R);
+		tp_vec3 _aFe;
+		get_vec3(aFe(m, b), _aFe);
+		mult_mtx33_vec3(aMiFe[b], _Iwi, _aFe);
 
-			tp_vec3 _pos, _anchor_local;
-			get_vec3(pos(m, body), _pos);
-			get_vec3(hanchor(m, h, i), _anchor_local);
+		tp_vec3 zero = {0.0, 0.0, 0.0};
+		set_vec3(zero, ta(m, b));
+		set_vec3(zero, aa(m, b));
+	}
 
-			mult_to_mtx33_vec3(_R, _anchor_local);
-			add_vec3(anchors_world[i], _pos, _anchor_local, TP_REAL(1.0));
-		}
+	for(int r = 0; r < num_active_rows(m); ++r)
+	{
+		index_t s = active_row(m, r);
 
-		tp_vec3 error;
-		add_vec3(error, anchors_world[1], anchors_world[0], TP_REAL(-1.0));
+		real_t dii = TP_REAL(0.0), JV = TP_REAL(0.0), JMiFe = TP_REAL(0.0);
 
-		*rhs(m, 5*h) 	+= (TP_ERP)/dt * error[0];
-		*rhs(m, 5*h+1) 	+= (TP_ERP)/dt * error[1];
-		*rhs(m, 5*h+2) 	+= (TP_ERP)/dt * error[2];
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
 
-		// Axis rotation error
-		tp_vec3 axis_local_1;
-		get_vec3(haxis_num(m, h, 1), axis_local_1);
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			index_t body = _Jm(m, s, bi);
 
-		tp_mtx33 _R1;
-		get_mtx33(R(m, _Jm(m, 5*h, 1)), _R1);
+			// B = M^{-1}J^{T}, the translational part constant for hinges and motors with a compact Jacobian
+			tp_vec3 _tJ, _tB;
+			get_row_tJ(m, s, bi, _tJ);
+			scale_vec3(_tB, _tJ, _mi(m, body));
+#ifdef TP_COMPACT_JACOBIAN
+			if(s >= TP_HINGE_MOTOR_CONSTRAINTS)
+#endif
+			set_vec3(_tB, tB(m, s, bi));
 
-		// Into world coords
-		mult_to_mtx33_vec3(_R1, axis_local_1);
+			tp_mtx33 _Iwi;
+			get_mtx33(Iwi(m, body), _Iwi);
 
-		tp_mtx33 _R0;
-		get_mtx33(R(m, _Jm(m, 5*h, 0)), _R0);
+			tp_vec3 _aJ, _aB;
+			get_vec3(aJ(m, s, bi), _aJ);
+			mult_mtx33_vec3(_aB, _Iwi, _aJ);
+			set_vec3(_aB, aB(m, s, bi));
 
-		// Into body 0 coords
-		mult_to_mtx33T_vec3(_R0, axis_local_1);
+			// d = diag(JB)
+			dii += dot_vec3(_tJ, _tB) + dot_vec3(_aJ, _aB);
 
-		tp_vec3 axis_local_0;
-		get_vec3(haxis(m, h), axis_local_0);
+			// JV and JM^{-1}Fe
+			tp_vec3 _vel, _omega;
+			get_vec3(vel(m, body), _vel);
+			get_vec3(omega(m, body), _omega);
+			JV += dot_vec3(_tJ, _vel) + dot_vec3(_aJ, _omega);
 
-		// u is in body 0 coords
-		tp_vec3 u;
-		cross_vec3(u, axis_local_0, axis_local_1);
+			JMiFe += dot_vec3(_tJ, tMiFe[body]) + dot_vec3(_aJ, aMiFe[body]);
 
-		tp_vec3 t0, t1;
-		get_vec3(ht0(m, h), t0);
-		get_vec3(ht1(m, h), t1);
+			// a = B\lambda_0
+			*x(ta(m, body)) += _lambda(m, s) * _tB[0];
+			*y(ta(m, body)) += _lambda(m, s) * _tB[1];
+			*z(ta(m, body)) += _lambda(m, s) * _tB[2];
 
-//		print_v3(u, "u", true);
+			*x(aa(m, body)) += _lambda(m, s) * _aB[0];
+			*y(aa(m, body)) += _lambda(m, s) * _aB[1];
+			*z(aa(m, body)) += _lambda(m, s) * _aB[2];
+		}
 
-		*rhs(m, 5*h+3) += (TP_ERP)/dt * dot_vec3(t0, u);
-		*rhs(m, 5*h+4) += (TP_ERP)/dt * dot_vec3(t1, u);
+		*d(m, s) = dii;
+		*di(m, s) = (dii > TP_REAL(1e-7) || dii < TP_REAL(-1e-7)) ? TP_REAL(1.0) / dii : TP_REAL(0.0);
+		*rhs(m, s) = -(TP_REAL(1.0)/dt) * JV - JMiFe;
 	}
 
-	// Add desired motor speed for the motor constraints
-	for(int s = TP_HINGE_CONSTRAINTS, motor = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s, ++motor)
-		*rhs(m, s) += _mds(m, motor)/dt;
+	TP_RELEASE_SCRATCH(tMiFe);
+
+	add_error_to_rhs(m, dt);
 }
 
 /** Clamps a change to a float variable.
@@ -422,93 +527,611 @@ real_t clamp2(real_t old, real_t delta, real_t min, real_t max)
 	return new_val;
 }
 
-/** Solves for Lagrange multiplier by Projected Gauss-Seidel.
+/** Computes \f$J_i\cdot a\f$ for one row of a given type.
  *
- * Computes \f$rhs = \frac{1}{\Delta t}\epsilon - \frac{1}{\Delta t}Ju - JM^{-1}F_e\f$.
- * Here \f$u\f$ represents the system velocity vector, and \f$F_e\f$ the external forces.
+ * The type is known at compile time, which removes the branch on the row range and
+ * unrolls the loop over the bodies. Contact rows only act on their foot, the second
+ * body. With #TP_COMPACT_JACOBIAN defined, the constant translational parts of the
+ * hinge and motor rows are not read, see get_row_tJ().
+ *
+ * @tparam		type		#TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT, see relax_type().
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		s			Row of the type, in interval [0, #TP_CONSTRAINTS-1].
+ * @return \f$J_i\cdot a\f$.
+ *
+ * @ingroup tp-dynamics
+ */
+template<int type>
+TP_FUNC_INLINE
+real_t row_dot_a_type(struct mem_t *m, index_t s)
+{
+	const int stop_at_body = (type == TP_RELAX_CONTACT) ? 1 : 0;
+
+	real_t tmp = TP_REAL(0.0);
+	for(int bi = 1; bi >= stop_at_body; --bi)
+	{
+		index_t body = _Jm(m, s, bi);
+
+#ifdef TP_COMPACT_JACOBIAN
+		if(type == TP_RELAX_CONTACT)
+#endif
+		{
+			tp_vec3 _tJ, _ta;
+			get_vec3(tJ(m, s, bi), _tJ);
+			get_vec3(ta(m, body), _ta);
+			tmp += dot_vec3(_tJ, _ta);
+		}
+
+		tp_vec3 _aJ, _aa;
+		get_vec3(aJ(m, s, bi), _aJ);
+		get_vec3(aa(m, body), _aa);
+		tmp += dot_vec3(_aJ, _aa);
+	}
+
+#ifdef TP_COMPACT_JACOBIAN
+	// Anchor rows of a hinge, the translational parts are e_k and -e_k
+	if(type == TP_RELAX_HINGE && s % 5 < 3)
+		tmp += *vec3_entry(ta(m, _Jm(m, s, 0)), s % 5) - *vec3_entry(ta(m, _Jm(m, s, 1)), s % 5);
+#endif
+
+	return tmp;
+}
+
+/** Computes \f$J_i\cdot a\f$ for one row, see row_dot_a_type().
  *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		s			Row, in interval [0, #TP_CONSTRAINTS-1].
+ * @return \f$J_i\cdot a\f$.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+real_t row_dot_a(struct mem_t *m, index_t s)
+{
+	if(s < TP_HINGE_CONSTRAINTS) return row_dot_a_type<TP_RELAX_HINGE>(m, s);
+	if(s < TP_HINGE_MOTOR_CONSTRAINTS) return row_dot_a_type<TP_RELAX_MOTOR>(m, s);
+	return row_dot_a_type<TP_RELAX_CONTACT>(m, s);
+}
+
+/** Adds to the Lagrange multiplier of one row of a given type, and updates
+ * \f$a = B\lambda\f$, see row_dot_a_type().
+ *
+ * @tparam		type			#TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT, see relax_type().
  * @param		m				Pointer to the memory representing the simulation world.
- * @param		dt				Simulation timestep.
- * @param		num_iterations	Number of iterations.
+ * @param		s				Row of the type to update, in interval [0, #TP_CONSTRAINTS-1].
+ * @param		delta_lambda	Change of the Lagrange multiplier.
+ *
+ * @ingroup tp-dynamics
+ */
+template<int type>
+TP_FUNC_INLINE
+void add_lambda_type(struct mem_t *m, index_t s, real_t delta_lambda)
+{
+	const int stop_at_body = (type == TP_RELAX_CONTACT) ? 1 : 0;
+
+	*lambda(m, s) += delta_lambda;
+
+	for(int bi = 1; bi >= stop_at_body; --bi)
+	{
+		index_t body = _Jm(m, s, bi);
+
+#ifdef TP_COMPACT_JACOBIAN
+		if(type == TP_RELAX_CONTACT)
+#endif
+		{
+			*x(ta(m, body)) += delta_lambda * _x(tB(m, s, bi));
+			*y(ta(m, body)) += delta_lambda * _y(tB(m, s, bi));
+			*z(ta(m, body)) += delta_lambda * _z(tB(m, s, bi));
+		}
+
+		*x(aa(m, body)) += delta_lambda * _x(aB(m, s, bi));
+		*y(aa(m, body)) += delta_lambda * _y(aB(m, s, bi));
+		*z(aa(m, body)) += delta_lambda * _z(aB(m, s, bi));
+	}
+
+#ifdef TP_COMPACT_JACOBIAN
+	if(type == TP_RELAX_HINGE && s % 5 < 3)
+	{
+		*vec3_entry(ta(m, _Jm(m, s, 0)), s % 5) += delta_lambda * _mi(m, _Jm(m, s, 0));
+		*vec3_entry(ta(m, _Jm(m, s, 1)), s % 5) -= delta_lambda * _mi(m, _Jm(m, s, 1));
+	}
+#endif
+}
+
+/** Adds to the Lagrange multiplier of one row, and updates \f$a = B\lambda\f$,
+ * see add_lambda_type().
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		s				Row to update, in interval [0, #TP_CONSTRAINTS-1].
+ * @param		delta_lambda	Change of the Lagrange multiplier.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+void add_lambda(struct mem_t *m, index_t s, real_t delta_lambda)
+{
+	if(s < TP_HINGE_CONSTRAINTS) add_lambda_type<TP_RELAX_HINGE>(m, s, delta_lambda);
+	else if(s < TP_HINGE_MOTOR_CONSTRAINTS) add_lambda_type<TP_RELAX_MOTOR>(m, s, delta_lambda);
+	else add_lambda_type<TP_RELAX_CONTACT>(m, s, delta_lambda);
+}
+
+/** Solves for the Lagrange multiplier of one row of a given type, one Projected
+ * Successive Over-Relaxation step.
+ *
+ * Computes \f$\Delta \lambda_i = \frac{\omega}{d_i}(rhs - J_i\cdot a)\f$, clamps the new
+ * multiplier to its limits, and updates \f$a\f$. The relaxation factor \f$\omega\f$
+ * depends on the type of the row, see relax(). With \f$\omega = 1\f$ this is the
+ * Projected Gauss-Seidel step.
+ *
+ * @tparam		type		#TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT, see relax_type().
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		s			Row of the type to solve for, in interval [0, #TP_CONSTRAINTS-1].
+ * @param		limits		Lower and upper limit of the row, instead of those of the world, or 0.
+ * @return the change \f$|\Delta \lambda_i|\f$ of the row.
+ *
+ * @ingroup tp-dynamics
+ */
+template<int type>
+TP_FUNC_INLINE
+real_t solve_row_type(struct mem_t *m, index_t s, const real_t *limits = 0)
+{
+	real_t tmp = row_dot_a_type<type>(m, s);
+
+	// Fix to avoid d = 0
+//	real_t dfix = _d(m, s) + (abs(_d(m, s) < 1e-7))*1e7;
+//	real_t delta_lambda = (_rhs(m, s) - tmp) / dfix;
+
+	// di is zero for d = 0, see setup_rows()
+	real_t delta_lambda = _relax(m, type) * (_rhs(m, s) - tmp) * _di(m, s);
+
+	// Limit lambda
+	real_t new_lambda = limits ?
+			clamp2(_lambda(m, s), delta_lambda, limits[0], limits[1]) :
+			clamp2(_lambda(m, s), delta_lambda, _lambda_min(m, s), _lambda_max(m, s));
+
+	delta_lambda = new_lambda - _lambda(m, s);
+
+	add_lambda_type<type>(m, s, delta_lambda);
+
+	return TP_ABS(delta_lambda);
+}
+
+/** Solves for the Lagrange multiplier of one row, see solve_row_type().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		s			Row to solve for, in interval [0, #TP_CONSTRAINTS-1].
+ * @return the change \f$|\Delta \lambda_i|\f$ of the row.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+real_t solve_row(struct mem_t *m, index_t s)
+{
+	if(s < TP_HINGE_CONSTRAINTS) return solve_row_type<TP_RELAX_HINGE>(m, s);
+	if(s < TP_HINGE_MOTOR_CONSTRAINTS) return solve_row_type<TP_RELAX_MOTOR>(m, s);
+	return solve_row_type<TP_RELAX_CONTACT>(m, s);
+}
+
+/** Solves the active rows of one type at the positions [@a first, @a last) of the
+ * sweep, see solve_row_type().
+ *
+ * The positions of the hinge rows are [0, #TP_HINGE_CONSTRAINTS), of the motor rows
+ * [#TP_HINGE_CONSTRAINTS, #TP_HINGE_MOTOR_CONSTRAINTS) and of the active contact rows
+ * [#TP_HINGE_MOTOR_CONSTRAINTS, num_active_rows()), see active_row().
+ *
+ * @tparam		type		#TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT, see relax_type().
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		first		First position.
+ * @param		last		Position after the last one.
+ * @param		backward	Solve from the last position to the first.
+ * @param		motor_limits	Lower and upper limit of each motor row, instead of those of the world, or 0.
+ * @return the largest change \f$|\Delta \lambda_i|\f$ of the rows.
+ *
+ * @ingroup tp-dynamics
+ */
+template<int type>
+TP_FUNC_INLINE
+real_t solve_rows_type(struct mem_t *m, int first, int last, bool backward, const real_t *motor_limits = 0)
+{
+	real_t max_delta = TP_REAL(0.0);
+
+	for(int i = 0; i < last - first; ++i)
+	{
+		int r = backward ? last - 1 - i : first + i;
+		index_t s = (type == TP_RELAX_CONTACT) ? _crow(m, r - TP_HINGE_MOTOR_CONSTRAINTS) : _rorder(m, r);
+
+		const real_t *limits = (type == TP_RELAX_MOTOR && motor_limits) ? motor_limits + 2*(s - TP_HINGE_CONSTRAINTS) : 0;
+
+		real_t delta = solve_row_type<type>(m, s, limits);
+		if(delta > max_delta) max_delta = delta;
+	}
+
+	return max_delta;
+}
+
+#ifdef TP_BLOCK_HINGES
+/** Computes the inverted hinge blocks.
+ *
+ * Computes \f$H_h^{-1}\f$ for every hinge \f$h\f$, where \f$H_h\f$ is the 5x5 block
+ * of \f$JB\f$ for the five rows of the hinge. If a block is singular, the inverse
+ * of its diagonal is used instead, which makes the block solve a row by row update.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
  *
  * @ingroup tp-dynamics
  */
 TP_FUNC
-void solve_for_lambda(struct mem_t *m, real_t dt, int num_iterations)
+void compute_Hi(struct mem_t *m)
 {
-	// Projected Gauss-Seidel, as from Catto paper
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		real_t H[25];
 
+		for(int i = 0; i < 5; ++i)
+		{
+			for(int j = 0; j < 5; ++j)
+			{
+				real_t hij = TP_REAL(0.0);
+
+				for(int bi = 1; bi >= 0; --bi)
+				{
+					for(int bj = 1; bj >= 0; --bj)
+					{
+						if(_Jm(m, 5*h+i, bi) != _Jm(m, 5*h+j, bj)) continue;
+
+						tp_vec3 _tJ, _tB;
+						get_row_tJ(m, 5*h+i, bi, _tJ);
+						get_row_tB(m, 5*h+j, bj, _tB);
+						hij += dot_vec3(_tJ, _tB);
+
+						tp_vec3 _aJ, _aB;
+						get_vec3(aJ(m, 5*h+i, bi), _aJ);
+						get_vec3(aB(m, 5*h+j, bj), _aB);
+						hij += dot_vec3(_aJ, _aB);
+					}
+				}
+
+				H[i*5+j] = hij;
+			}
+		}
+
+		real_t _Hi[25];
+		if(!invert_mtx55(_Hi, H))
+		{
+			for(int i = 0; i < 25; ++i) _Hi[i] = TP_REAL(0.0);
+
+			for(int i = 0; i < 5; ++i)
+				_Hi[i*5+i] = _di(m, 5*h+i);
+		}
+
+		for(int i = 0; i < 5; ++i)
+			for(int j = 0; j < 5; ++j)
+				*Hi(m, h, i, j) = _Hi[i*5+j];
+	}
+}
+
+/** Solves the five rows of a hinge together, one block Gauss-Seidel step.
+ *
+ * Computes \f$\Delta \lambda_h = \omega H_h^{-1}(rhs_h - J_h a)\f$ for the rows of the hinge,
+ * clamps the new multipliers to their limits, and updates \f$a\f$, see compute_Hi().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		h			Hinge to solve for, in interval [0, #TP_HINGES-1].
+ * @return the largest change \f$|\Delta \lambda_i|\f$ of the rows.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+real_t solve_hinge_block(struct mem_t *m, int h)
+{
+	real_t residual[5];
+	for(int i = 0; i < 5; ++i)
+	{
+		index_t s = 5*h + i;
+
+		real_t tmp = TP_REAL(0.0);
+		for(int bi = 1; bi >= 0; --bi)
+		{
+			index_t body = _Jm(m, s, bi);
+
+			tp_vec3 _tJ, _ta;
+			get_row_tJ(m, s, bi, _tJ);
+			get_vec3(ta(m, body), _ta);
+			tmp += dot_vec3(_tJ, _ta);
+
+			tp_vec3 _aJ, _aa;
+			get_vec3(aJ(m, s, bi), _aJ);
+			get_vec3(aa(m, body), _aa);
+			tmp += dot_vec3(_aJ, _aa);
+		}
+
+		residual[i] = _rhs(m, s) - tmp;
+	}
+
+	real_t max_delta = TP_REAL(0.0);
+	for(int i = 0; i < 5; ++i)
+	{
+		index_t s = 5*h + i;
+
+		real_t delta_lambda = TP_REAL(0.0);
+		for(int j = 0; j < 5; ++j)
+			delta_lambda += _Hi(m, h, i, j) * residual[j];
+		delta_lambda *= _relax(m, TP_RELAX_HINGE);
+
+		// Limit lambda
+		real_t new_lambda = clamp2(_lambda(m, s), delta_lambda, _lambda_min(m, s), _lambda_max(m, s));
+
+		delta_lambda = new_lambda - _lambda(m, s);
+
+		*lambda(m, s) += delta_lambda;
+
+		if(TP_ABS(delta_lambda) > max_delta)
+			max_delta = TP_ABS(delta_lambda);
+
+		for(int bi = 1; bi >= 0; --bi)
+		{
+			index_t body = _Jm(m, s, bi);
+
+			tp_vec3 _tB;
+			get_row_tB(m, s, bi, _tB);
+
+			*x(ta(m, body)) += delta_lambda * _tB[0];
+			*y(ta(m, body)) += delta_lambda * _tB[1];
+			*z(ta(m, body)) += delta_lambda * _tB[2];
+
+			*x(aa(m, body)) += delta_lambda * _x(aB(m, s, bi));
+			*y(aa(m, body)) += delta_lambda * _y(aB(m, s, bi));
+			*z(aa(m, body)) += delta_lambda * _z(aB(m, s, bi));
+		}
+	}
+
+	return max_delta;
+}
+#endif
+
+/** State of the sweeps of one solve, see prepare_sweep().
+ *
+ * @ingroup tp-dynamics
+ */
+struct sweep_t
+{
+	int first_row;				// First active row solved one at a time
+	int num_sweeps;				// Sweeps run, for alternating the direction
+	const real_t *motor_limits;	// Limits of the motor rows, if not those of the world, see project_positions()
+#ifdef TP_TREE_SOLVER
+	struct tree_t tree;			// Factorization of the hinge rows
+#endif
+};
+
+/** Starts the sweeps of a solve, with \f$B\f$ and \f$d\f$ already computed.
+ *
+ * If #TP_TREE_SOLVER or #TP_BLOCK_HINGES is defined, the hinge rows are factored.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param[out]	sweep			State of the sweeps.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void factor_sweep(struct mem_t *m, struct sweep_t *sweep)
+{
+	sweep->num_sweeps = 0;
+	sweep->motor_limits = 0;
+
+#if defined(TP_TREE_SOLVER)
+	sweep->first_row = factor_tree(m, &sweep->tree) ? TP_HINGE_CONSTRAINTS : 0;
+#elif defined(TP_BLOCK_HINGES)
+	compute_Hi(m);		// Hi = inverse of the hinge blocks of JB
+	sweep->first_row = TP_HINGE_CONSTRAINTS;
+#else
+	sweep->first_row = 0;
+#endif
+}
+
+/** Computes the quantities of the constraint solver that are fixed during one solve.
+ *
+ * Computes \f$B\f$, \f$a\f$, \f$d\f$ and \f$rhs = \frac{1}{\Delta t}\epsilon - \frac{1}{\Delta t}Ju - JM^{-1}F_e\f$,
+ * see setup_rows(). Here \f$u\f$ represents the system velocity vector, and \f$F_e\f$
+ * the external forces. If #TP_TREE_SOLVER or #TP_BLOCK_HINGES is defined, the hinge rows are also factored.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		dt				Simulation timestep.
+ * @param[out]	sweep			State of the sweeps.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void prepare_sweep(struct mem_t *m, real_t dt, struct sweep_t *sweep)
+{
 	/* CUDA: Better to compute on empty rows, or better to quit
 	 * and wait in a synchronization? Test? For now, empty rows!
 	 */
 
 	// Solves JB\lambda = rhs (J = sparse, B = sparse)
-	compute_B(m);		// B = M^{-1}J^{T}
-	compute_a(m);		// a = B\lambda_0
-	compute_d(m);		// d = diag(JB)
-	compute_rhs(m, dt);	// rhs = 1/dt*e - 1/dt*Jv - M^{-1}F_e
+	setup_rows(m, dt);	// B = M^{-1}J^{T}, a = B\lambda_0, d = diag(JB), di = 1/d, rhs = 1/dt*e - 1/dt*Jv - M^{-1}F_e
 
-	for(int i = 0; i < num_iterations; ++i)
+	factor_sweep(m, sweep);
+}
+
+/** Runs one Projected Gauss-Seidel sweep over the active rows.
+ *
+ * The rows are taken in the order of active_row(), see order_rows(). If
+ * #TP_SYMMETRIC_SWEEPS is defined, every second sweep takes them in reverse order,
+ * starting with the contact rows. The hinge, motor and contact rows are solved by
+ * kernels specialised for their type, see solve_rows_type().
+ *
+ * If #TP_BLOCK_HINGES is defined, the five rows of each hinge are solved together,
+ * see solve_hinge_block(), before the motor and contact rows. If #TP_TREE_SOLVER
+ * is defined, all hinge rows are instead solved exactly, see solve_tree().
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		sweep			State of the sweeps, see prepare_sweep().
+ * @return the largest change \f$|\Delta \lambda_i|\f$ of the sweep.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+real_t sweep_rows(struct mem_t *m, struct sweep_t *sweep)
+{
+	real_t max_delta = TP_REAL(0.0);
+
+#if defined(TP_TREE_SOLVER)
+	if(sweep->first_row > 0)
 	{
-//		real_t delta = 0.0;
-		for(int s = 0; s < TP_CONSTRAINTS; ++s)
-		{
-			index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+		real_t delta = solve_tree(m, &sweep->tree);
+		if(delta > max_delta) max_delta = delta;
+	}
+#elif defined(TP_BLOCK_HINGES)
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		real_t delta = solve_hinge_block(m, h);
+		if(delta > max_delta) max_delta = delta;
+	}
+#endif
 
-			real_t tmp = TP_REAL(0.0);
-			for(int bi = 1; bi >= stop_at_body; --bi)
-			{
-				index_t body = _Jm(m, s, bi);
+	bool backward = false;
+#ifdef TP_SYMMETRIC_SWEEPS
+	backward = (sweep->num_sweeps++ % 2);
+#endif
 
-				tp_vec3 _tJ;
-				get_vec3(tJ(m, s, bi), _tJ);
+	// The hinge, motor and contact rows by their own kernels
+	int hinge_first = sweep->first_row;
+	int motor_first = (hinge_first > TP_HINGE_CONSTRAINTS) ? hinge_first : TP_HINGE_CONSTRAINTS;
+	int contact_first = (hinge_first > TP_HINGE_MOTOR_CONSTRAINTS) ? hinge_first : TP_HINGE_MOTOR_CONSTRAINTS;
+
+	real_t delta[3];
+	if(backward)
+	{
+		delta[2] = solve_rows_type<TP_RELAX_CONTACT>(m, contact_first, num_active_rows(m), true);
+		delta[1] = solve_rows_type<TP_RELAX_MOTOR>(m, motor_first, TP_HINGE_MOTOR_CONSTRAINTS, true, sweep->motor_limits);
+		delta[0] = solve_rows_type<TP_RELAX_HINGE>(m, hinge_first, TP_HINGE_CONSTRAINTS, true);
+	}
+	else
+	{
+		delta[0] = solve_rows_type<TP_RELAX_HINGE>(m, hinge_first, TP_HINGE_CONSTRAINTS, false);
+		delta[1] = solve_rows_type<TP_RELAX_MOTOR>(m, motor_first, TP_HINGE_MOTOR_CONSTRAINTS, false, sweep->motor_limits);
+		delta[2] = solve_rows_type<TP_RELAX_CONTACT>(m, contact_first, num_active_rows(m), false);
+	}
 
-				tp_vec3 _ta;
-				get_vec3(ta(m, body), _ta);
+	for(int i = 0; i < 3; ++i)
+		if(delta[i] > max_delta) max_delta = delta[i];
 
-				tmp += dot_vec3(_tJ, _ta);
+	return max_delta;
+}
 
-				tp_vec3 _aJ;
-				get_vec3(aJ(m, s, bi), _aJ);
+/** Solves for Lagrange multiplier by Projected Gauss-Seidel.
+ *
+ * The iterations stop early when the largest change \f$|\Delta \lambda_i|\f$ of a sweep
+ * is below @a tolerance. With the default tolerance of zero all iterations are run.
+ * See prepare_sweep() and sweep_rows().
+ *
+ * If #TP_TREE_SOLVER is defined and there are no motor and contact rows, one sweep
+ * suffices.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		dt				Simulation timestep.
+ * @param		num_iterations	Maximum number of iterations.
+ * @param		tolerance		Largest change in a Lagrange multiplier for which a sweep is considered converged.
+ * @return the number of iterations run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+int solve_for_lambda(struct mem_t *m, real_t dt, int num_iterations, real_t tolerance = TP_REAL(0.0))
+{
+	// Projected Gauss-Seidel, as from Catto paper
+	struct sweep_t sweep;
+	prepare_sweep(m, dt, &sweep);
 
-				tp_vec3 _aa;
-				get_vec3(aa(m, body), _aa);
+	for(int i = 0; i < num_iterations; ++i)
+	{
+		if(sweep_rows(m, &sweep) < tolerance)
+			return i + 1;
+	}
 
-				tmp += dot_vec3(_aJ, _aa);
-			}
+	return num_iterations;
+}
 
-			// Fix to avoid d = 0
-//			real_t dfix = _d(m, s) + (abs(_d(m, s) < 1e-7))*1e7;
-//			real_t delta_lambda = (_rhs(m, s) - tmp) / dfix;
+/** Solves for Lagrange multiplier by Nonsmooth Nonlinear Conjugate Gradient.
+ *
+ * Every Projected Gauss-Seidel sweep, see sweep_rows(), is followed by a step along
+ * a conjugate direction, as presented in:
+ *
+ * M. Silcowitz, S. Niebe and K. Erleben. A nonsmooth nonlinear conjugate gradient
+ * method for interactive contact force problems. The Visual Computer, 26(6):893–901, 2010.
+ *
+ * The change of the multipliers by a sweep, \f$r_k = \lambda_{k+1} - \lambda_k\f$, is
+ * the negative gradient. With \f$\beta_k = |r_k|^2 / |r_{k-1}|^2\f$ the direction is
+ * \f$p_k = r_k + \beta_k p_{k-1}\f$ and the multipliers get \f$\beta_k p_{k-1}\f$ added,
+ * clamped to their limits. If \f$\beta_k > 1\f$ the direction is restarted.
+ *
+ * Chains with high mass ratios need far fewer sweeps than with solve_for_lambda().
+ * Selected by step_world() if #TP_NNCG is defined. The iterations stop early when
+ * the largest change of a sweep is below @a tolerance.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		dt				Simulation timestep.
+ * @param		num_iterations	Maximum number of iterations.
+ * @param		tolerance		Largest change in a Lagrange multiplier for which a sweep is considered converged.
+ * @return the number of iterations run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+int solve_for_lambda_nncg(struct mem_t *m, real_t dt, int num_iterations, real_t tolerance = TP_REAL(0.0))
+{
+	struct sweep_t sweep;
+	prepare_sweep(m, dt, &sweep);
+
+	TP_SCRATCH_ARRAY(real_t, last_lambda, TP_CONSTRAINTS);
+	TP_SCRATCH_ARRAY(real_t, p, TP_CONSTRAINTS);
+	for(int s = 0; s < TP_CONSTRAINTS; ++s) p[s] = TP_REAL(0.0);
+
+	real_t last_norm = TP_REAL(0.0);
 
-			real_t delta_lambda = TP_REAL(0.0);
-			if(_d(m, s) > TP_REAL(1e-7) || _d(m, s) < TP_REAL(-1e-7))
-				delta_lambda = (_rhs(m, s) - tmp) / _d(m, s);
+	for(int i = 0; i < num_iterations; ++i)
+	{
+		for(int r = 0; r < num_active_rows(m); ++r)
+			last_lambda[r] = _lambda(m, active_row(m, r));
 
-//			if(s == 40)
-//			delta = delta_lambda;
-			// Limit lambda
-			real_t new_lambda = clamp2(_lambda(m, s), delta_lambda, _lambda_min(m, s), _lambda_max(m, s));
+		if(sweep_rows(m, &sweep) < tolerance)
+		{
+			TP_RELEASE_SCRATCH(last_lambda);
+			return i + 1;
+		}
 
-			delta_lambda = new_lambda - _lambda(m, s);
+		// |r_k|^2, r_k = \lambda_{k+1} - \lambda_k
+		real_t norm = TP_REAL(0.0);
+		for(int r = 0; r < num_active_rows(m); ++r)
+		{
+			real_t residual = _lambda(m, active_row(m, r)) - last_lambda[r];
+			norm += residual * residual;
+		}
 
-			*lambda(m, s) += delta_lambda;
+		real_t beta = (last_norm > TP_REAL(0.0)) ? norm / last_norm : TP_REAL(0.0);
+		last_norm = norm;
 
-			for(int bi = 1; bi >= stop_at_body; --bi)
+		for(int r = 0; r < num_active_rows(m); ++r)
+		{
+			index_t s = active_row(m, r);
+			real_t residual = _lambda(m, s) - last_lambda[r];
+
+			// Restart
+			if(beta > TP_REAL(1.0))
 			{
-				index_t body = _Jm(m, s, bi);
+				p[r] = residual;
+				continue;
+			}
 
-				*x(ta(m, body)) += delta_lambda * _x(tB(m, s, bi));
-				*y(ta(m, body)) += delta_lambda * _y(tB(m, s, bi));
-				*z(ta(m, body)) += delta_lambda * _z(tB(m, s, bi));
+			real_t new_lambda = clamp2(_lambda(m, s), beta * p[r], _lambda_min(m, s), _lambda_max(m, s));
+			add_lambda(m, s, new_lambda - _lambda(m, s));
 
-				*x(aa(m, body)) += delta_lambda * _x(aB(m, s, bi));
-				*y(aa(m, body)) += delta_lambda * _y(aB(m, s, bi));
-				*z(aa(m, body)) += delta_lambda * _z(aB(m, s, bi));
-			}
+			p[r] = residual + beta * p[r];
 		}
-//		std::cout << delta/5.0 << std::endl;
 	}
+
+	TP_RELEASE_SCRATCH(last_lambda);
+	return num_iterations;
 }
 
 //@}
@@ -48,10 +48,7 @@ real_t hinge_angle(struct mem_t *m, index_t hinge_num)
 
 	// Convert quaternion to angle (from ODE source)
 	tp_vec3 axis;
-	get_vec3(haxis(m, hinge_num), axis);
-	tp_mtx33 R0;
-	get_mtx33(R(m, b0), R0);
-	mult_to_mtx33_vec3(R0, axis);
+	get_vec3(haxis_world(m, hinge_num, 0), axis);
 
 	real_t cost2 = hdq[0];
 	real_t sint2 = sqrt(hdq[1]*hdq[1] + hdq[2]*hdq[2] + hdq[3]*hdq[3]);
@@ -79,15 +76,9 @@ real_t hinge_angle_rate(struct mem_t *m, index_t hinge_num)
 	index_t b0 = _Jm(m, 5*hinge_num, 0);
 	index_t b1 = _Jm(m, 5*hinge_num, 1);
 
-	tp_mtx33 R0;
-	get_mtx33(R(m, b0), R0);
-
-	// The axis is stored in the ref. frame of body 0
+	// The axis of body 0, in world frame
 	tp_vec3 axis;
-	get_vec3(haxis(m, hinge_num), axis);
-
-	// To world frame
-	mult_to_mtx33_vec3(R0, axis);
+	get_vec3(haxis_world(m, hinge_num, 0), axis);
 
 	tp_vec3 omega0;
 	get_vec3(omega(m, b0), omega0);
@@ -0,0 +1,65 @@
+/*
+ * kinematics.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+
+/** Updates the kinematics cache of a world.
+ *
+ * The world inverse inertia \f$R I_b^{-1} R^{T}\f$ of every body, and the hinge
+ * anchors and axes in world coordinates, depend only on the rotation of the bodies.
+ * They are computed here once, and then read by the Jacobian update, the constraint
+ * solver, the integration and the hinge feedback functions, see Iwi(),
+ * hanchor_world() and haxis_world().
+ *
+ * step_world() updates the cache after integrating. It must be called by the user
+ * when the world has been configured, and whenever the positions, rotations or
+ * inertias are changed from outside of the stepping functions.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void update_kinematics(struct mem_t *m)
+{
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		tp_mtx33 _Ibi;
+		get_mtx33(Ibi(m, b), _Ibi);
+
+		tp_mtx33 _R;
+		get_mtx33(R(m, b), _R);
+
+		tp_mtx33 IbiRT;
+		mult_mtx33_mtx33T(IbiRT, _Ibi, _R);
+
+		tp_mtx33 _Iwi;
+		mult_mtx33_mtx33(_Iwi, _R, IbiRT);
+
+		set_mtx33(_Iwi, Iwi(m, b));
+	}
+
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_mtx33 _R;
+			get_mtx33(R(m, _Jm(m, 5*h, i)), _R);
+
+			tp_vec3 local, world;
+
+			get_vec3(hanchor(m, h, i), local);
+			mult_mtx33_vec3(world, _R, local);
+			set_vec3(world, hanchor_world(m, h, i));
+
+			get_vec3(haxis_num(m, h, i), local);
+			mult_mtx33_vec3(world, _R, local);
+			set_vec3(world, haxis_world(m, h, i));
+		}
+	}
+}
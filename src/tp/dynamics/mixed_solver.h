@@ -0,0 +1,211 @@
+/*
+ * mixed_solver.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+/**
+ * @name Mixed Precision Solver Functions
+ *
+ * The Projected Gauss-Seidel sweeps run on a copy of \f$J\f$, \f$B\f$ and \f$d\f$ in
+ * #sweep_real_t, which is @b float by default. Every #TP_MIXED_SWEEPS sweeps the
+ * multipliers are refined in #real_t: the sweeps solve for a correction
+ * \f$\Delta\lambda\f$ of the residual system
+ * \f[
+ * 	JB\Delta\lambda = rhs - J\cdot a, \quad \lambda_{min} - \lambda \le \Delta\lambda \le \lambda_{max} - \lambda
+ * \f]
+ * which is then added to \f$\lambda\f$ and \f$a\f$. The accuracy is that of #real_t,
+ * while most of the work streams half as many bytes.
+ *
+ * Only available if #TP_MIXED_PRECISION is defined.
+ */
+//@{
+
+#ifndef TP_MIXED_SWEEPS
+/** Number of sweeps in #sweep_real_t between two refinements in #real_t.
+ * @ingroup tp-dynamics
+ */
+#define TP_MIXED_SWEEPS 8
+#endif
+
+/** Low precision copy of the constraint system, see load_mixed().
+ * @ingroup tp-dynamics
+ */
+struct mixed_t
+{
+	sweep_real_t J[TP_CONSTRAINTS*12];			// Rows of J, per body translational then angular
+	sweep_real_t B[TP_CONSTRAINTS*12];			// Columns of B, same layout as J
+	sweep_real_t di[TP_CONSTRAINTS];			// \omega/d_i, zero if d_i is singular
+	sweep_real_t rhs[TP_CONSTRAINTS];			// Residual rhs - J\cdot a
+	sweep_real_t lambda[TP_CONSTRAINTS];		// Correction of lambda
+	sweep_real_t lambda_min[TP_CONSTRAINTS];	// Lower limit of the correction
+	sweep_real_t lambda_max[TP_CONSTRAINTS];	// Upper limit of the correction
+	sweep_real_t a[TP_BODIES*6];				// B times the correction
+};
+
+/** Copies \f$J\f$, \f$B\f$ and \f$d\f$ of the active rows to the low precision system.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param[out]	mixed		Low precision system.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void load_mixed(struct mem_t *m, struct mixed_t *mixed)
+{
+	for(int r = 0; r < num_active_rows(m); ++r)
+	{
+		index_t s = active_row(m, r);
+
+		int stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			tp_vec3 _tJ, _tB;
+			get_row_tJ(m, s, bi, _tJ);
+			get_row_tB(m, s, bi, _tB);
+
+			tp_vec3 _aJ, _aB;
+			get_vec3(aJ(m, s, bi), _aJ);
+			get_vec3(aB(m, s, bi), _aB);
+
+			for(int k = 0; k < 3; ++k)
+			{
+				mixed->J[s*12+bi*6+k] = (sweep_real_t)_tJ[k];
+				mixed->J[s*12+bi*6+3+k] = (sweep_real_t)_aJ[k];
+				mixed->B[s*12+bi*6+k] = (sweep_real_t)_tB[k];
+				mixed->B[s*12+bi*6+3+k] = (sweep_real_t)_aB[k];
+			}
+		}
+
+		mixed->di[s] = (sweep_real_t)(_relax(m, relax_type(m, s)) * _di(m, s));
+	}
+}
+
+/** Computes the residual system of the current multipliers, see \ref tp-dynamics.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		mixed		Low precision system.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void residual_mixed(struct mem_t *m, struct mixed_t *mixed)
+{
+	for(int r = 0; r < num_active_rows(m); ++r)
+	{
+		index_t s = active_row(m, r);
+
+		mixed->rhs[s] = (sweep_real_t)(_rhs(m, s) - row_dot_a(m, s));
+		mixed->lambda[s] = 0.0f;
+		mixed->lambda_min[s] = (sweep_real_t)(_lambda_min(m, s) - _lambda(m, s));
+		mixed->lambda_max[s] = (sweep_real_t)(_lambda_max(m, s) - _lambda(m, s));
+	}
+
+	for(int i = 0; i < (TP_BODIES)*6; ++i) mixed->a[i] = 0.0f;
+}
+
+/** Runs one Projected Gauss-Seidel sweep over the active rows of the low precision system.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		mixed		Low precision system.
+ * @return the largest change \f$|\Delta \lambda_i|\f$ of the sweep.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+sweep_real_t sweep_mixed(struct mem_t *m, struct mixed_t *mixed)
+{
+	sweep_real_t max_delta = 0.0f;
+
+	for(int r = 0; r < num_active_rows(m); ++r)
+	{
+		index_t s = active_row(m, r);
+		int stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		const sweep_real_t *J = mixed->J + s*12;
+		const sweep_real_t *B = mixed->B + s*12;
+
+		sweep_real_t tmp = 0.0f;
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			const sweep_real_t *a = mixed->a + _Jm(m, s, bi)*6;
+			for(int k = 0; k < 6; ++k) tmp += J[bi*6+k] * a[k];
+		}
+
+		sweep_real_t new_lambda = mixed->lambda[s] + mixed->di[s] * (mixed->rhs[s] - tmp);
+		if(new_lambda > mixed->lambda_max[s]) new_lambda = mixed->lambda_max[s];
+		if(new_lambda < mixed->lambda_min[s]) new_lambda = mixed->lambda_min[s];
+
+		sweep_real_t delta_lambda = new_lambda - mixed->lambda[s];
+		mixed->lambda[s] = new_lambda;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			sweep_real_t *a = mixed->a + _Jm(m, s, bi)*6;
+			for(int k = 0; k < 6; ++k) a[k] += delta_lambda * B[bi*6+k];
+		}
+
+		if(delta_lambda > max_delta) max_delta = delta_lambda;
+		if(-delta_lambda > max_delta) max_delta = -delta_lambda;
+	}
+
+	return max_delta;
+}
+
+/** Solves for Lagrange multiplier by mixed precision Projected Gauss-Seidel.
+ *
+ * Runs the sweeps in #sweep_real_t and refines the multipliers in #real_t every
+ * #TP_MIXED_SWEEPS sweeps, see \ref tp-dynamics. Hinge rows are solved one at a
+ * time, also if #TP_BLOCK_HINGES or #TP_TREE_SOLVER is defined. Selected by
+ * step_world() if #TP_MIXED_PRECISION is defined. The iterations stop early when the
+ * largest change of a sweep is below @a tolerance.
+ *
+ * @param		m				Pointer to the memory representing the simulation world.
+ * @param		dt				Simulation timestep.
+ * @param		num_iterations	Maximum number of sweeps.
+ * @param		tolerance		Largest change in a Lagrange multiplier for which a sweep is considered converged.
+ * @return the number of sweeps run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+int solve_for_lambda_mixed(struct mem_t *m, real_t dt, int num_iterations, real_t tolerance = TP_REAL(0.0))
+{
+	setup_rows(m, dt);	// B = M^{-1}J^{T}, a = B\lambda_0, d = diag(JB), di = 1/d, rhs = 1/dt*e - 1/dt*Jv - M^{-1}F_e
+
+	struct mixed_t mixed;
+	load_mixed(m, &mixed);
+
+	int i = 0;
+	bool converged = false;
+	while(i < num_iterations && !converged)
+	{
+		residual_mixed(m, &mixed);
+
+		for(int k = 0; k < TP_MIXED_SWEEPS && i < num_iterations; ++k)
+		{
+			++i;
+			if(sweep_mixed(m, &mixed) < tolerance)
+			{
+				converged = true;
+				break;
+			}
+		}
+
+		// Refine in full precision
+		for(int r = 0; r < num_active_rows(m); ++r)
+		{
+			index_t s = active_row(m, r);
+			real_t new_lambda = clamp2(_lambda(m, s), (real_t)mixed.lambda[s], _lambda_min(m, s), _lambda_max(m, s));
+			add_lambda(m, s, new_lambda - _lambda(m, s));
+		}
+	}
+
+	return i;
+}
+
+//@}
@@ -1,74 +1,216 @@
-
 #pragma once
 
 
-/** Steps a simulation world a dt amount of seconds.
+#ifdef TP_POST_STABILIZATION
+#ifndef TP_PROJECTION_ITERATIONS
+/** Number of sweeps of project_positions() run by integrate_world().
+ * @ingroup tp-dynamics
+ */
+#define TP_PROJECTION_ITERATIONS 4
+#endif
+#endif
+
+/** Moves the bodies to remove the drift of the hinges, without changing their
+ * velocities.
+ *
+ * Post-stabilization, as presented in:
+ *
+ * M. B. Cline and D. K. Pai. Post-stabilization for rigid body simulation with
+ * contact and constraints. In Proc. IEEE ICRA, pages 3744–3751, 2003.
+ *
+ * The constraint solver is run once more, with the \f$J\f$, \f$B\f$ and \f$d\f$
+ * of the step, see sweep_rows(), for the position correction
+ * \f[
+ * 	\Delta x = M^{-1}J^{T}\lambda = a, \quad JM^{-1}J^{T}\lambda = \mathrm{ERP}\cdot\epsilon
+ * \f]
+ * where the hinge error \f$\epsilon\f$ is measured at the positions after the
+ * integration, as in compute_rhs(). \f$J\f$, \f$B\f$ and \f$d\f$, with its inverse,
+ * are those of the rotations before the integration, as set up by the solver, and are not updated
+ * for the new rotations. The correction is therefore first order in the rotation
+ * of a step, and the remaining error is corrected by the next step. The correction
+ * is a position, not an impulse, so it adds no energy, unlike the bias of
+ * compute_rhs().
+ *
+ * Here \f$\lambda\f$ is a force times the square of the timestep. The motor rows
+ * have zero error, so the motors hold their angles, within their force limits
+ * scaled by \f$dt^2\f$. The scaled limits are passed to the sweeps, see sweep_t, and
+ * the world is only read, so worlds sharing a model can be projected in parallel.
+ *
+ * Only the hinge and motor rows are solved, integrate_world() calls it after the
+ * contact rows are cleared. With the contact rows as well, the corrections of a
+ * walking robot did not stay bounded. The contact rows of the next step keep the
+ * feet from moving further into the ground.
+ *
+ * The Lagrange multipliers of the step are restored afterwards, since the next step
+ * starts from them, see compute_a(). integrate_world() runs #TP_PROJECTION_ITERATIONS
+ * sweeps, if #TP_POST_STABILIZATION is defined. The kinematics cache is not updated,
+ * see update_kinematics().
  *
  * @param		m				Pointer to the memory representing world.
- * @param		dt				Size of timestep (seconds).
- * @param		num_iterations	Number of iterations to use in constraint force solver.
+ * @param		dt				Size of the timestep (seconds) just integrated.
+ * @param		num_iterations	Number of sweeps.
  *
  * @ingroup tp-dynamics
  */
 TP_FUNC
-void step_world(struct mem_t *m, real_t dt, int num_iterations)
+void project_positions(struct mem_t *m, real_t dt, int num_iterations)
 {
-	// Update Jacobian for constraints (hinges)
-	update_jacobian(m);
+	// The multipliers of the step, and a zero start for the correction
+	TP_SCRATCH_ARRAY(real_t, step_lambda, TP_CONSTRAINTS);
+	for(int r = 0; r < num_active_rows(m); ++r)
+	{
+		index_t s = active_row(m, r);
 
-	// Compute contraint+contact lambdas
-	solve_for_lambda(m, dt, num_iterations);
+		step_lambda[r] = _lambda(m, s);
+		*lambda(m, s) = TP_REAL(0.0);
+		*rhs(m, s) = TP_REAL(0.0);
+	}
+
+	// The force limits of the motors, as limits of force*dt^2. The limits of the world
+	// are not written, they may be those of a shared model, see memory/shared.h
+	TP_SCRATCH_ARRAY(real_t, motor_limits, 2*((TP_MOTORS) > 0 ? (TP_MOTORS) : 1));	// Not empty without motors
+	for(int k = 0; k < (TP_MOTORS); ++k)
+	{
+		index_t s = TP_HINGE_CONSTRAINTS + k;
+
+		motor_limits[2*k] = dt*dt*_lambda_min(m, s);
+		motor_limits[2*k+1] = dt*dt*_lambda_max(m, s);
+	}
+
+	compute_a(m);
+
+	// rhs = ERP*e, with the anchors and axes at the new rotations
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		tp_vec3 anchors_world[2], axes_world[2];
+
+		for(int i = 0; i < 2; ++i)
+		{
+			index_t body = _Jm(m, 5*h, i);
 
-	// Add constraint+contact forces to external forces
-	compute_Fc_add_to_Fe(m);
+			tp_mtx33 _R;
+			get_mtx33(R(m, body), _R);
 
+			tp_vec3 local;
+			get_vec3(hanchor(m, h, i), local);
+			mult_mtx33_vec3(anchors_world[i], _R, local);
+
+			tp_vec3 _pos;
+			get_vec3(pos(m, body), _pos);
+			add_to_vec3(anchors_world[i], _pos, TP_REAL(1.0));
+
+			get_vec3(haxis_num(m, h, i), local);
+			mult_mtx33_vec3(axes_world[i], _R, local);
+		}
+
+		tp_vec3 error;
+		add_vec3(error, anchors_world[1], anchors_world[0], TP_REAL(-1.0));
+
+		*rhs(m, 5*h) 	= (TP_ERP) * error[0];
+		*rhs(m, 5*h+1) 	= (TP_ERP) * error[1];
+		*rhs(m, 5*h+2) 	= (TP_ERP) * error[2];
+
+		tp_vec3 u;
+		cross_vec3(u, axes_world[0], axes_world[1]);
+
+		// The tangent base of the step, as set up by update_jacobian()
+		tp_vec3 t0, t1;
+		get_vec3(aJ(m, 5*h+3, 0), t0);
+		get_vec3(aJ(m, 5*h+4, 0), t1);
+
+		*rhs(m, 5*h+3) = (TP_ERP) * dot_vec3(t0, u);
+		*rhs(m, 5*h+4) = (TP_ERP) * dot_vec3(t1, u);
+	}
+
+	struct sweep_t sweep;
+	factor_sweep(m, &sweep);
+	sweep.motor_limits = motor_limits;
+
+	for(int i = 0; i < num_iterations; ++i)
+		sweep_rows(m, &sweep);
+
+	// x += a
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		*x(pos(m, b)) += _x(ta(m, b));
+		*y(pos(m, b)) += _y(ta(m, b));
+		*z(pos(m, b)) += _z(ta(m, b));
+
+		tp_vec3 _aa;
+		get_vec3(aa(m, b), _aa);
+
+		tp_quatern _quatern;
+		get_quatern(quatern(m, b), _quatern);
+		integrate_quaternion_exp(_quatern, _aa, TP_REAL(1.0));
+		set_quatern(_quatern, quatern(m, b));
+
+		tp_mtx33 _R;
+		quaternion_to_rot_mtx33(_quatern, _R);
+		set_mtx33(_R, R(m, b));
+	}
+
+	for(int r = 0; r < num_active_rows(m); ++r)
+		*lambda(m, active_row(m, r)) = step_lambda[r];
+
+	TP_RELEASE_SCRATCH(step_lambda);
+}
+
+/** Applies the constraint forces and integrates a simulation world a dt amount
+ * of seconds, the part of step_world() after the constraint solver.
+ *
+ * The constraint forces enter through \f$a = M^{-1}J^{T}\lambda\f$, which the
+ * solver keeps up to date for every body, so each body is integrated in one pass
+ * that reads its own state only, instead of first scattering \f$J^{T}\lambda\f$
+ * into the external forces, see compute_Fc_add_to_Fe(). The Jacobian is not read.
+ *
+ * The forces and the active contact rows are cleared for the next step. If
+ * #TP_POST_STABILIZATION is defined the drift of the hinges is then removed from the
+ * positions, see project_positions(). Last, the kinematics cache is updated, see
+ * update_kinematics().
+ *
+ * @param		m				Pointer to the memory representing world.
+ * @param		dt				Size of timestep (seconds).
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void integrate_world(struct mem_t *m, real_t dt)
+{
 	#ifdef TP_DEBUG
 	compute_Fc(m);
 	#endif
 
-	// Integrate with semi-implicit Euler
+	// Integrate with semi-implicit Euler, v += dt*(M^{-1}F_e + a)
 	for(int i = 0; i < (TP_BODIES); ++i)
 	{
 		// Velocity update, translational ---------------------------
 		tp_vec3 _tFe;
 		get_vec3(tFe(m, i), _tFe);
 
-		*x(vel(m, i)) += dt * _mi(m, i) * _tFe[0];
-		*y(vel(m, i)) += dt * _mi(m, i) * _tFe[1];
-		*z(vel(m, i)) += dt * _mi(m, i) * _tFe[2];
+		tp_vec3 _ta;
+		get_vec3(ta(m, i), _ta);
 
-		// Velocity update, rotational ------------------------------
-		tp_mtx33 _Ibi;
-		get_mtx33(Ibi(m, i), _Ibi);
+		*x(vel(m, i)) += dt * (_mi(m, i) * _tFe[0] + _ta[0]);
+		*y(vel(m, i)) += dt * (_mi(m, i) * _tFe[1] + _ta[1]);
+		*z(vel(m, i)) += dt * (_mi(m, i) * _tFe[2] + _ta[2]);
 
-		tp_mtx33 _R;
-		get_mtx33(R(m, i), _R);
+		// Velocity update, rotational ------------------------------
+		tp_mtx33 _Iwi;
+		get_mtx33(Iwi(m, i), _Iwi);
 
 		tp_vec3 _aFe;
 		get_vec3(aFe(m, i), _aFe);
 
-		tp_mtx33 IbiRT;
-		mult_mtx33_mtx33T(IbiRT, _Ibi, _R);
-
-		tp_mtx33 Ii;
-		mult_mtx33_mtx33(Ii, _R, IbiRT);
+		mult_to_mtx33_vec3(_Iwi, _aFe);
 
-		mult_to_mtx33_vec3(Ii, _aFe);
+		tp_vec3 _aa;
+		get_vec3(aa(m, i), _aa);
 
-		*x(omega(m, i)) += dt * _aFe[0];
-		*y(omega(m, i)) += dt * _aFe[1];
-		*z(omega(m, i)) += dt * _aFe[2];
+		*x(omega(m, i)) += dt * (_aFe[0] + _aa[0]);
+		*y(omega(m, i)) += dt * (_aFe[1] + _aa[1]);
+		*z(omega(m, i)) += dt * (_aFe[2] + _aa[2]);
 
-// 		Gyroscopic update -------------------------------------------
-//		tp_vec3 Iw, wxIw, _omega;
-//		get_vec3(omega(m, i), _omega);
-//		mult_mtx33_vec3(Iw, Iwi, _omega);
-//		cross_vec3(wxIw, _omega, Iw);
-//		std::cout << "|wxIw| = " << norm2_vec3(wxIw) << std::endl;
-//		*x(omega(m, i)) += dt * (Iwite[0] - wxIw[0]);
-//		*y(omega(m, i)) += dt * (Iwite[1] - wxIw[1]);
-//		*z(omega(m, i)) += dt * (Iwite[2] - wxIw[2]);
-//		-------------------------------------------------------------
+		// The gyroscopic torque is in aFe if #TP_GYROSCOPIC is defined, see add_gyroscopic_torque()
 
 		// Position update, translational ---------------------------
 		*x(pos(m, i)) += dt * _x(vel(m, i));
@@ -82,6 +224,9 @@ void step_world(struct mem_t *m, real_t dt, int num_iterations)
 		tp_quatern _quatern;
 		get_quatern(quatern(m, i), _quatern);
 
+#ifdef TP_EXP_MAP
+		integrate_quaternion_exp(_quatern, _omega, dt);
+#else
 		tp_quatern dq;
 		mult_omega_quatern(dq, _omega, _quatern);
 
@@ -90,8 +235,11 @@ void step_world(struct mem_t *m, real_t dt, int num_iterations)
 		_quatern[2] += dt * TP_REAL(0.5) * dq[2];
 		_quatern[3] += dt * TP_REAL(0.5) * dq[3];
 		normalize_quaternion(_quatern);
+#endif
 
 		set_quatern(_quatern, quatern(m, i));
+
+		tp_mtx33 _R;
 		quaternion_to_rot_mtx33(_quatern, _R);
 		set_mtx33(_R, R(m, i));
 
@@ -104,14 +252,368 @@ void step_world(struct mem_t *m, real_t dt, int num_iterations)
 		*x(aFe(m, i)) = TP_REAL(0.0);
 		*y(aFe(m, i)) = TP_REAL(0.0);
 		*z(aFe(m, i)) = TP_REAL(0.0);
+	}
+
+	// Zero the active contact rows, and make them inactive
+	for(int c = 0; c < _ncrows(m); ++c)
+	{
+		tp_vec3 zero = {0.0, 0.0, 0.0};
+		set_vec3(zero, tJ(m, _crow(m, c), 1));
+		set_vec3(zero, aJ(m, _crow(m, c), 1));
+	}
+	*ncrows(m) = 0;
+
+#ifdef TP_POST_STABILIZATION
+	project_positions(m, dt, TP_PROJECTION_ITERATIONS);
+#endif
+
+	// World inertia, anchors and axes for the new rotations
+	update_kinematics(m);
+}
 
-		// Zero contact rows
-		for(int s = TP_HINGE_MOTOR_CONSTRAINTS; s < TP_CONSTRAINTS; ++s)
+/** Adds the gyroscopic torque of every body to its external torque, linearized
+ * for implicit integration.
+ *
+ * The angular velocity after the step, \f$\omega'\f$, should satisfy
+ * \f[
+ * 	I(\omega' - \omega) + dt\,\omega' \times I\omega' = 0
+ * \f]
+ * in the absence of other torques. In body coordinates, where the inertia \f$I\f$ is
+ * constant, one Newton step from \f$\omega\f$ gives
+ * \f[
+ * 	\Delta\omega = -\left(I + dt([\omega]_\times I - [I\omega]_\times)\right)^{-1} dt\,\omega \times I\omega
+ * \f]
+ * which is added as the torque \f$RI\Delta\omega/dt\f$, so that the constraint solver
+ * accounts for it. Unlike the explicit torque \f$-\omega \times I\omega\f$ it does not
+ * add energy, and stays stable for fast spinning bodies at large dt, at the cost of
+ * some damping of tumbling bodies. Bodies without an invertible inertia are skipped.
+ *
+ * @param		m				Pointer to the memory representing world.
+ * @param		dt				Size of timestep (seconds).
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+void add_gyroscopic_torque(struct mem_t *m, real_t dt)
+{
+	for(int i = 0; i < (TP_BODIES); ++i)
+	{
+		tp_mtx33 _Ibi;
+		get_mtx33(Ibi(m, i), _Ibi);
+
+		tp_mtx33 Ib;
+		if(!invert_mtx33(Ib, _Ibi)) continue;
+
+		tp_mtx33 _R;
+		get_mtx33(R(m, i), _R);
+
+		// In body coordinates, where the inertia is constant
+		tp_vec3 _omega;
+		get_vec3(omega(m, i), _omega);
+		mult_to_mtx33T_vec3(_R, _omega);
+
+		tp_vec3 Ib_omega;
+		mult_mtx33_vec3(Ib_omega, Ib, _omega);
+
+		tp_vec3 f;
+		cross_vec3(f, _omega, Ib_omega);
+		scale_to_vec3(f, dt);
+
+		// Jacobian of f, I + dt([\omega]_x I - [I\omega]_x)
+		tp_mtx33 Jf;
+		for(int c = 0; c < 3; ++c)
 		{
-			tp_vec3 zero = {0.0, 0.0, 0.0};
-			set_vec3(zero, tJ(m, s, 1));
-			set_vec3(zero, aJ(m, s, 1));
+			tp_vec3 column = {Ib[0*TP_SIZE_VEC3+c], Ib[1*TP_SIZE_VEC3+c], Ib[2*TP_SIZE_VEC3+c]};
+
+			tp_vec3 omega_x_column;
+			cross_vec3(omega_x_column, _omega, column);
+
+			tp_vec3 e = {TP_REAL(0.0), TP_REAL(0.0), TP_REAL(0.0)};
+			e[c] = TP_REAL(1.0);
+
+			tp_vec3 Ib_omega_x_e;
+			cross_vec3(Ib_omega_x_e, Ib_omega, e);
+
+			for(int r = 0; r < 3; ++r)
+				Jf[r*TP_SIZE_VEC3+c] = column[r] + dt * (omega_x_column[r] - Ib_omega_x_e[r]);
+		}
+
+		tp_mtx33 Jfi;
+		if(!invert_mtx33(Jfi, Jf)) continue;
+
+		tp_vec3 delta_omega;
+		mult_mtx33_vec3(delta_omega, Jfi, f);
+
+		// The torque R I \Delta\omega / dt, in world coordinates
+		tp_vec3 torque;
+		mult_mtx33_vec3(torque, Ib, delta_omega);
+		mult_to_mtx33_vec3(_R, torque);
+
+		*x(aFe(m, i)) -= torque[0] / dt;
+		*y(aFe(m, i)) -= torque[1] / dt;
+		*z(aFe(m, i)) -= torque[2] / dt;
+	}
+}
+
+/** Steps a simulation world a dt amount of seconds.
+ *
+ * The kinematics cache must be up to date when the function is called, see
+ * update_kinematics(). It is updated again after the integration. The constraint
+ * forces are solved by solve_for_lambda(), by solve_for_lambda_nncg() if #TP_NNCG
+ * is defined, or by solve_for_lambda_mixed() if #TP_MIXED_PRECISION is defined.
+ * If #TP_GYROSCOPIC is defined the gyroscopic torques are added first, see
+ * add_gyroscopic_torque().
+ *
+ * @param		m				Pointer to the memory representing world.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ * @return the number of solver iterations run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+int step_world(struct mem_t *m, real_t dt, int num_iterations, real_t tolerance = TP_REAL(0.0))
+{
+#ifdef TP_GYROSCOPIC
+	add_gyroscopic_torque(m, dt);
+#endif
+
+	// Update Jacobian for constraints (hinges)
+	update_jacobian(m);
+
+	// Compute contraint+contact lambdas
+#if defined(TP_NNCG)
+	int iterations = solve_for_lambda_nncg(m, dt, num_iterations, tolerance);
+#elif defined(TP_MIXED_PRECISION)
+	int iterations = solve_for_lambda_mixed(m, dt, num_iterations, tolerance);
+#else
+	int iterations = solve_for_lambda(m, dt, num_iterations, tolerance);
+#endif
+
+	// Forces, integration and kinematics
+	integrate_world(m, dt);
+
+	return iterations;
+}
+
+
+/** State of a body at the start of a step of step_world_adaptive(), for restarting
+ * the step with smaller substeps.
+ *
+ * @ingroup tp-dynamics
+ */
+struct body_state_t
+{
+	tp_vec3 position;
+	tp_quatern quaternion;
+	tp_mtx33 rotation;
+	tp_vec3 velocity;
+	tp_vec3 angular_velocity;
+	tp_vec3 force;
+	tp_vec3 torque;
+};
+
+/** Active contact row at the start of a step of step_world_adaptive(). The rows
+ * are cleared by every substep, and are restored for the next.
+ *
+ * @ingroup tp-dynamics
+ */
+struct contact_state_t
+{
+	index_t row;
+	tp_vec3 translational;
+	tp_vec3 angular;
+};
+
+/** Returns the largest distance between the two anchors of a hinge, the drift of the
+ * joints left by the last step.
+ *
+ * @param		m				Pointer to the memory representing world.
+ * @return the largest distance.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+real_t joint_drift(struct mem_t *m)
+{
+	real_t drift = TP_REAL(0.0);
+
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		tp_vec3 anchor[2];
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_vec3 _pos, _anchor;
+			get_vec3(pos(m, _Jm(m, 5*h, i)), _pos);
+			get_vec3(hanchor_world(m, h, i), _anchor);
+			add_vec3(anchor[i], _pos, _anchor, TP_REAL(1.0));
 		}
+
+		tp_vec3 gap;
+		add_vec3(gap, anchor[1], anchor[0], TP_REAL(-1.0));
+
+		real_t distance = norm2_vec3(gap);
+		if(distance > drift) drift = distance;
 	}
+
+	return drift;
 }
 
+/** Steps a simulation world a dt amount of seconds in one or more substeps, chosen
+ * by an estimate of the local error.
+ *
+ * The step is taken as @a substeps substeps of step_world(). After each substep the
+ * error is estimated as the larger of the joint drift, see joint_drift(), and the
+ * depth the feet move into the ground during the substep, the approach velocity left
+ * on the normal contact rows times the substep. If it exceeds @a max_error the step
+ * is restarted from its initial state with twice as many substeps, up to
+ * @a max_substeps, and with the Lagrange multipliers it started from. The external
+ * forces and the contact rows set up for the step are applied in every substep.
+ *
+ * The contact rows keep the normals and lever arms of the collision at the start of
+ * the step, the feet are not collided again for each substep. A foot that rolls or
+ * slides far within the step thus pushes at its initial contact points, as with one
+ * step of dt. This is a known limitation, collide and step with a smaller dt where
+ * the contact points move quickly.
+ *
+ * On return @a substeps holds the number of substeps to start the next step with,
+ * halved if the error was below a quarter of @a max_error. Violent steps, such as
+ * foot touchdown, are thereby subdivided while smooth phases are taken in one step
+ * of dt.
+ *
+ * @param		m				Pointer to the memory representing world.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver, per substep.
+ * @param		max_error		Largest accepted error of a step (meters).
+ * @param		max_substeps	Largest number of substeps of a step.
+ * @param[in,out]	substeps	Number of substeps to start the step with, and to start the next step with.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ * @return the number of solver iterations run, by all substeps.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+int step_world_adaptive(
+		struct mem_t *m,
+		real_t dt,
+		int num_iterations,
+		real_t max_error,
+		int max_substeps,
+		int *substeps,
+		real_t tolerance = TP_REAL(0.0))
+{
+	TP_SCRATCH_ARRAY(struct body_state_t, saved, TP_BODIES);
+	for(int i = 0; i < (TP_BODIES); ++i)
+	{
+		get_vec3(pos(m, i), saved[i].position);
+		get_quatern(quatern(m, i), saved[i].quaternion);
+		get_mtx33(R(m, i), saved[i].rotation);
+		get_vec3(vel(m, i), saved[i].velocity);
+		get_vec3(omega(m, i), saved[i].angular_velocity);
+		get_vec3(tFe(m, i), saved[i].force);
+		get_vec3(aFe(m, i), saved[i].torque);
+	}
+
+	TP_SCRATCH_ARRAY(real_t, saved_lambda, TP_CONSTRAINTS);
+	for(int s = 0; s < TP_CONSTRAINTS; ++s) saved_lambda[s] = _lambda(m, s);
+
+	int num_contacts = _ncrows(m);
+	TP_SCRATCH_ARRAY(struct contact_state_t, contacts, TP_CONTACT_CONSTRAINTS*((TP_FEET) > 0 ? (TP_FEET) : 1));	// Not empty without feet
+	for(int c = 0; c < num_contacts; ++c)
+	{
+		contacts[c].row = _crow(m, c);
+		get_vec3(tJ(m, contacts[c].row, 1), contacts[c].translational);
+		get_vec3(aJ(m, contacts[c].row, 1), contacts[c].angular);
+	}
+
+	int n = *substeps;
+	if(n > max_substeps) n = max_substeps;
+	if(n < 1) n = 1;
+
+	int iterations = 0;
+	real_t error;
+
+	for(;;)
+	{
+		real_t h = dt / n;
+		error = TP_REAL(0.0);
+
+		int k;
+		for(k = 0; k < n; ++k)
+		{
+			// The first substep finds the forces and contact rows in place
+			if(k > 0)
+			{
+				for(int i = 0; i < (TP_BODIES); ++i)
+				{
+					set_vec3(saved[i].force, tFe(m, i));
+					set_vec3(saved[i].torque, aFe(m, i));
+				}
+
+				for(int c = 0; c < num_contacts; ++c)
+				{
+					set_vec3(contacts[c].translational, tJ(m, contacts[c].row, 1));
+					set_vec3(contacts[c].angular, aJ(m, contacts[c].row, 1));
+					activate_contact_row(m, contacts[c].row);
+				}
+			}
+
+			iterations += step_world(m, h, num_iterations, tolerance);
+
+			real_t drift = joint_drift(m);
+			if(drift > error) error = drift;
+
+			// The depth at each contact point: all TP_CONTACTS_ON_FOOT normal rows of a foot,
+			// which come before its tangent rows, are measured, the tangent rows are skipped
+			for(int c = 0; c < num_contacts; ++c)
+			{
+				index_t s = contacts[c].row;
+				if((s - TP_HINGE_MOTOR_CONSTRAINTS) % TP_CONTACT_CONSTRAINTS >= TP_CONTACTS_ON_FOOT) continue;
+
+				index_t body = _Jm(m, s, 1);
+
+				tp_vec3 _vel, _omega;
+				get_vec3(vel(m, body), _vel);
+				get_vec3(omega(m, body), _omega);
+
+				real_t depth = -h * (dot_vec3(contacts[c].translational, _vel) + dot_vec3(contacts[c].angular, _omega));
+				if(depth > error) error = depth;
+			}
+
+			if(error > max_error && n < max_substeps) break;
+		}
+
+		if(k == n) break;
+
+		// Restart the step from its initial state
+		for(int i = 0; i < (TP_BODIES); ++i)
+		{
+			set_vec3(saved[i].position, pos(m, i));
+			set_quatern(saved[i].quaternion, quatern(m, i));
+			set_mtx33(saved[i].rotation, R(m, i));
+			set_vec3(saved[i].velocity, vel(m, i));
+			set_vec3(saved[i].angular_velocity, omega(m, i));
+			set_vec3(saved[i].force, tFe(m, i));
+			set_vec3(saved[i].torque, aFe(m, i));
+		}
+
+		for(int s = 0; s < TP_CONSTRAINTS; ++s) *lambda(m, s) = saved_lambda[s];
+
+		for(int c = 0; c < num_contacts; ++c)
+		{
+			set_vec3(contacts[c].translational, tJ(m, contacts[c].row, 1));
+			set_vec3(contacts[c].angular, aJ(m, contacts[c].row, 1));
+			activate_contact_row(m, contacts[c].row);
+		}
+
+		update_kinematics(m);
+
+		n = (2*n < max_substeps) ? 2*n : max_substeps;
+	}
+
+	*substeps = (n > 1 && error < TP_REAL(0.25)*max_error) ? n/2 : n;
+
+	TP_RELEASE_SCRATCH(saved);
+	return iterations;
+}
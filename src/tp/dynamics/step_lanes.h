@@ -0,0 +1,758 @@
+/*
+ * step_lanes.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+/**
+ * @name Lane-per-world Functions
+ *
+ * Versions of the stepping functions that step all #TP_LANES worlds of a
+ * memory/interleaved.h block at once, with one world per SIMD lane. The
+ * computations are the same as in update_jacobian(), solve_for_lambda() and
+ * step_world(). Since each row of the Projected Gauss-Seidel sweep does the
+ * same work for every world, the lanes never diverge. Bodies referenced by the
+ * Jacobian map are fetched per lane, so the worlds of a block need not share
+ * the same model.
+ *
+ * The functions take the handle of lane 0 of the block.
+ */
+//@{
+
+/** Returns the number of leading rows that hold the active rows of all worlds in a block.
+ *
+ * The lanes process the same rows, so a contact row is skipped only if it is inactive
+ * in every lane. Inactive contact rows have zero Jacobian entries, see
+ * activate_contact_row(), so a lane processing a row that is inactive for its world
+ * leaves the world unchanged.
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @return one past the last contact row that is active in any lane.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+int num_rows_lanes(struct mem_t *m)
+{
+	int num_rows = TP_HINGE_MOTOR_CONSTRAINTS;
+
+	for(int l = 0; l < (int)(TP_LANES); ++l)
+	{
+		struct mem_t world;
+		world.block = m->block;
+		world.lane = l;
+
+		for(int c = 0; c < _ncrows(&world); ++c)
+		{
+			int end = _crow(&world, c) + 1;
+			num_rows = (end > num_rows) ? end : num_rows;
+		}
+	}
+
+	return num_rows;
+}
+
+/** Updates the kinematics cache of all worlds in a block, see update_kinematics().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void update_kinematics_lanes(struct mem_t *m)
+{
+	const ptrdiff_t stride_R = R(m, 1) - R(m, 0);
+
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		tp_mtx33_lanes _Ibi, _R, IbiRT, _Iwi;
+		get_mtx33_lanes(Ibi(m, b), _Ibi);
+		get_mtx33_lanes(R(m, b), _R);
+
+		mult_mtx33_mtx33T_lanes(IbiRT, _Ibi, _R);
+		mult_mtx33_mtx33_lanes(_Iwi, _R, IbiRT);
+		set_mtx33_lanes(_Iwi, Iwi(m, b));
+	}
+
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_mtx33_lanes _R;
+			gather_mtx33_lanes(R(m, 0), stride_R, Jm(m, 5*h, i), _R);
+
+			tp_vec3_lanes local, world;
+
+			get_vec3_lanes(hanchor(m, h, i), local);
+			mult_mtx33_vec3_lanes(world, _R, local);
+			set_vec3_lanes(world, hanchor_world(m, h, i));
+
+			get_vec3_lanes(haxis_num(m, h, i), local);
+			mult_mtx33_vec3_lanes(world, _R, local);
+			set_vec3_lanes(world, haxis_world(m, h, i));
+		}
+	}
+}
+
+/** Updates the Jacobian of all worlds in a block, see update_jacobian().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void update_jacobian_lanes(struct mem_t *m)
+{
+	const ptrdiff_t stride_R = R(m, 1) - R(m, 0);
+
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		// Add rotational parts to Jacobian, (R * local_anchor)^x ---
+		for(int b = 0; b < 2; ++b)
+		{
+			tp_vec3_lanes anchor_world;
+			get_vec3_lanes(hanchor_world(m, h, b), anchor_world);
+
+			// -a x for body 0, a x for body 1
+			const real_t sign = (b == 0) ? TP_REAL(1.0) : TP_REAL(-1.0);
+
+			tp_vec3_lanes row[3];
+			TP_FOR_LANES(l)
+			{
+				real_t a0 = sign*anchor_world[0][l];
+				real_t a1 = sign*anchor_world[1][l];
+				real_t a2 = sign*anchor_world[2][l];
+
+				row[0][0][l] = TP_REAL(0.0);	row[0][1][l] = a2;				row[0][2][l] = -a1;
+				row[1][0][l] = -a2;				row[1][1][l] = TP_REAL(0.0);	row[1][2][l] = a0;
+				row[2][0][l] = a1;				row[2][1][l] = -a0;				row[2][2][l] = TP_REAL(0.0);
+			}
+
+			for(int r = 0; r < 3; ++r)
+				set_vec3_lanes(row[r], aJ(m, 5*h+r, b));
+		}
+
+		// Jacobian rows for axis tangent base ----------------------
+		// Axis of body 0 is used
+		tp_mtx33_lanes _R0;
+		gather_mtx33_lanes(R(m, 0), stride_R, Jm(m, 5*h, 0), _R0);
+
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_vec3_lanes t_local, t;
+			get_vec3_lanes((i == 0) ? ht0(m, h) : ht1(m, h), t_local);
+			mult_mtx33_vec3_lanes(t, _R0, t_local);
+			set_vec3_lanes(t, aJ(m, 5*h+3+i, 0));
+
+			TP_FOR_LANES(l)
+			{
+				t[0][l] = -t[0][l];
+				t[1][l] = -t[1][l];
+				t[2][l] = -t[2][l];
+			}
+			set_vec3_lanes(t, aJ(m, 5*h+3+i, 1));
+		}
+	}
+
+	for(int s = TP_HINGE_CONSTRAINTS, motor = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s, ++motor)
+	{
+		// The axis of the first body of the hinge, in world coords
+		tp_vec3_lanes axis;
+		gather_vec3_lanes(haxis_world(m, 0, 0), haxis_world(m, 1, 0) - haxis_world(m, 0, 0), mm(m, motor), axis);
+		set_vec3_lanes(axis, aJ(m, s, 1));
+
+		TP_FOR_LANES(l)
+		{
+			axis[0][l] = -axis[0][l];
+			axis[1][l] = -axis[1][l];
+			axis[2][l] = -axis[2][l];
+		}
+		set_vec3_lanes(axis, aJ(m, s, 0));
+	}
+}
+
+/** Computes the B vector of all worlds in a block, see compute_B().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		num_rows	Number of rows to process, see num_rows_lanes().
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void compute_B_lanes(struct mem_t *m, int num_rows)
+{
+	const ptrdiff_t stride_mi = mi(m, 1) - mi(m, 0);
+	const ptrdiff_t stride_Iwi = Iwi(m, 1) - Iwi(m, 0);
+
+	for(int s = 0; s < num_rows; ++s)
+	{
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			const index_t *body = Jm(m, s, bi);
+
+			// Scale the translational components by 1/m = mi
+			tp_lanes _mi;
+			gather_lanes(mi(m, 0), stride_mi, body, _mi);
+
+			tp_vec3_lanes _tJ;
+			get_vec3_lanes(tJ(m, s, bi), _tJ);
+			scale_to_vec3_lanes(_tJ, _mi);
+			set_vec3_lanes(_tJ, tB(m, s, bi));
+
+			// Set the rotational components to Iwi * rotational components
+			tp_mtx33_lanes _Iwi;
+			gather_mtx33_lanes(Iwi(m, 0), stride_Iwi, body, _Iwi);
+
+			tp_vec3_lanes _aJ, _aB;
+			get_vec3_lanes(aJ(m, s, bi), _aJ);
+			mult_mtx33_vec3_lanes(_aB, _Iwi, _aJ);
+			set_vec3_lanes(_aB, aB(m, s, bi));
+		}
+	}
+}
+
+/** Computes the \f$a\f$ vector of all worlds in a block, see compute_a().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		num_rows	Number of rows to process, see num_rows_lanes().
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void compute_a_lanes(struct mem_t *m, int num_rows)
+{
+	const ptrdiff_t stride_a = ta(m, 1) - ta(m, 0);
+
+	tp_vec3_lanes zero;
+	for(int k = 0; k < 3; ++k)
+	{
+		TP_FOR_LANES(l)
+			zero[k][l] = TP_REAL(0.0);
+	}
+
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		set_vec3_lanes(zero, ta(m, b));
+		set_vec3_lanes(zero, aa(m, b));
+	}
+
+	for(int s = 0; s < num_rows; ++s)
+	{
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			const index_t *body = Jm(m, s, bi);
+
+			tp_vec3_lanes _tB, _aB;
+			get_vec3_lanes(tB(m, s, bi), _tB);
+			get_vec3_lanes(aB(m, s, bi), _aB);
+
+			scatter_add_vec3_lanes(_tB, lambda(m, s), ta(m, 0), stride_a, body);
+			scatter_add_vec3_lanes(_aB, lambda(m, s), aa(m, 0), stride_a, body);
+		}
+	}
+}
+
+/** Computes the \f$d\f$ vector of all worlds in a block, see compute_d().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		num_rows	Number of rows to process, see num_rows_lanes().
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void compute_d_lanes(struct mem_t *m, int num_rows)
+{
+	for(int s = 0; s < num_rows; ++s)
+	{
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		tp_lanes dii;
+		TP_FOR_LANES(l)
+			dii[l] = TP_REAL(0.0);
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			tp_vec3_lanes _J, _B;
+			tp_lanes dot;
+
+			get_vec3_lanes(tJ(m, s, bi), _J);
+			get_vec3_lanes(tB(m, s, bi), _B);
+			dot_vec3_lanes(dot, _J, _B);
+			TP_FOR_LANES(l)
+				dii[l] += dot[l];
+
+			get_vec3_lanes(aJ(m, s, bi), _J);
+			get_vec3_lanes(aB(m, s, bi), _B);
+			dot_vec3_lanes(dot, _J, _B);
+			TP_FOR_LANES(l)
+				dii[l] += dot[l];
+		}
+
+		real_t *_d = d(m, s);
+		TP_FOR_LANES(l)
+			_d[l] = dii[l];
+	}
+}
+
+/** Computes the \f$rhs\f$ vector of all worlds in a block, see compute_rhs().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		num_rows	Number of rows to process, see num_rows_lanes().
+ * @param		dt			Simulation timestep.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void compute_rhs_lanes(struct mem_t *m, int num_rows, real_t dt)
+{
+	const ptrdiff_t stride_v = vel(m, 1) - vel(m, 0);
+	const ptrdiff_t stride_mi = mi(m, 1) - mi(m, 0);
+	const ptrdiff_t stride_Iwi = Iwi(m, 1) - Iwi(m, 0);
+	const ptrdiff_t stride_q = pos(m, 1) - pos(m, 0);
+
+	// rhs = \frac{1}{\Delta t}\epsilon - \frac{1}{\Delta t}JV - JM^{-1}F_e
+	for(int s = 0; s < num_rows; ++s)
+	{
+		tp_lanes JV, JMiFe;
+		TP_FOR_LANES(l)
+		{
+			JV[l] = TP_REAL(0.0);
+			JMiFe[l] = TP_REAL(0.0);
+		}
+
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			const index_t *body = Jm(m, s, bi);
+
+			tp_vec3_lanes _tJ, _aJ;
+			get_vec3_lanes(tJ(m, s, bi), _tJ);
+			get_vec3_lanes(aJ(m, s, bi), _aJ);
+
+			tp_vec3_lanes _vel, _omega;
+			gather_vec3_lanes(vel(m, 0), stride_v, body, _vel);
+			gather_vec3_lanes(omega(m, 0), stride_v, body, _omega);
+
+			tp_lanes tdot, adot;
+
+			// JV (translational) + (rotational)
+			dot_vec3_lanes(tdot, _tJ, _vel);
+			dot_vec3_lanes(adot, _aJ, _omega);
+			TP_FOR_LANES(l)
+				JV[l] += tdot[l] + adot[l];
+
+			tp_lanes _mi;
+			gather_lanes(mi(m, 0), stride_mi, body, _mi);
+
+			tp_vec3_lanes _tFe, _aFe;
+			gather_vec3_lanes(tFe(m, 0), stride_v, body, _tFe);
+			gather_vec3_lanes(aFe(m, 0), stride_v, body, _aFe);
+			scale_to_vec3_lanes(_tFe, _mi);
+
+			tp_mtx33_lanes _Iwi;
+			gather_mtx33_lanes(Iwi(m, 0), stride_Iwi, body, _Iwi);
+
+			tp_vec3_lanes Iwi_aFe;
+			mult_mtx33_vec3_lanes(Iwi_aFe, _Iwi, _aFe);
+
+			// JM^{-1}Fe (translational) + (rotational)
+			dot_vec3_lanes(tdot, _tJ, _tFe);
+			dot_vec3_lanes(adot, _aJ, Iwi_aFe);
+			TP_FOR_LANES(l)
+				JMiFe[l] += tdot[l] + adot[l];
+		}
+
+		real_t *_rhs = rhs(m, s);
+		TP_FOR_LANES(l)
+			_rhs[l] = -(TP_REAL(1.0)/dt) * JV[l] - JMiFe[l];
+	}
+
+	// Error correction for hinges
+	for(int h = 0; h < (TP_HINGES); ++h)
+	{
+		tp_vec3_lanes anchors_world[2];
+
+		for(int i = 0; i < 2; ++i)
+		{
+			tp_vec3_lanes _pos, _anchor;
+			gather_vec3_lanes(pos(m, 0), stride_q, Jm(m, 5*h, i), _pos);
+			get_vec3_lanes(hanchor_world(m, h, i), _anchor);
+
+			TP_FOR_LANES(l)
+			{
+				anchors_world[i][0][l] = _pos[0][l] + TP_REAL(1.0)*_anchor[0][l];
+				anchors_world[i][1][l] = _pos[1][l] + TP_REAL(1.0)*_anchor[1][l];
+				anchors_world[i][2][l] = _pos[2][l] + TP_REAL(1.0)*_anchor[2][l];
+			}
+		}
+
+		// Axis rotation error, in world coords
+		tp_vec3_lanes axis_world_0, axis_world_1, u;
+		get_vec3_lanes(haxis_world(m, h, 0), axis_world_0);
+		get_vec3_lanes(haxis_world(m, h, 1), axis_world_1);
+		cross_vec3_lanes(u, axis_world_0, axis_world_1);
+
+		tp_vec3_lanes t0, t1;
+		get_vec3_lanes(aJ(m, 5*h+3, 0), t0);
+		get_vec3_lanes(aJ(m, 5*h+4, 0), t1);
+
+		tp_lanes t0u, t1u;
+		dot_vec3_lanes(t0u, t0, u);
+		dot_vec3_lanes(t1u, t1, u);
+
+		for(int k = 0; k < 3; ++k)
+		{
+			real_t *_rhs = rhs(m, 5*h+k);
+			TP_FOR_LANES(l)
+				_rhs[l] += (TP_ERP)/dt * (anchors_world[1][k][l] + TP_REAL(-1.0)*anchors_world[0][k][l]);
+		}
+
+		real_t *_rhs3 = rhs(m, 5*h+3);
+		real_t *_rhs4 = rhs(m, 5*h+4);
+		TP_FOR_LANES(l)
+		{
+			_rhs3[l] += (TP_ERP)/dt * t0u[l];
+			_rhs4[l] += (TP_ERP)/dt * t1u[l];
+		}
+	}
+
+	// Add desired motor speed for the motor constraints
+	for(int s = TP_HINGE_CONSTRAINTS, motor = 0; s < TP_HINGE_MOTOR_CONSTRAINTS; ++s, ++motor)
+	{
+		real_t *_rhs = rhs(m, s);
+		const real_t *_mds = mds(m, motor);
+		TP_FOR_LANES(l)
+			_rhs[l] += _mds[l]/dt;
+	}
+}
+
+/** Solves for Lagrange multiplier by Projected Gauss-Seidel, for all worlds
+ * in a block. See solve_for_lambda(). The iterations stop early once the
+ * sweeps of all lanes have converged.
+ *
+ * The hinge and motor rows are taken in the row order of lane 0, which must be
+ * the same in all lanes, see order_rows(). The contact rows follow in index
+ * order. If #TP_SYMMETRIC_SWEEPS is defined, every second sweep takes the rows in
+ * reverse order, as solve_for_lambda().
+ *
+ * @param		m				Handle of lane 0 of the block.
+ * @param		num_rows		Number of rows to process, see num_rows_lanes().
+ * @param		dt				Simulation timestep.
+ * @param		num_iterations	Maximum number of iterations.
+ * @param		tolerance		Largest change in a Lagrange multiplier for which a sweep is considered converged.
+ * @return the number of iterations run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+int solve_for_lambda_lanes(struct mem_t *m, int num_rows, real_t dt, int num_iterations, real_t tolerance)
+{
+	compute_B_lanes(m, num_rows);			// B = M^{-1}J^{T}
+	compute_a_lanes(m, num_rows);			// a = B\lambda_0
+	compute_d_lanes(m, num_rows);			// d = diag(JB)
+	compute_rhs_lanes(m, num_rows, dt);	// rhs = 1/dt*e - 1/dt*Jv - M^{-1}F_e
+
+	const ptrdiff_t stride_a = ta(m, 1) - ta(m, 0);
+
+#ifndef NDEBUG
+	// The lanes process the same rows
+	for(int r = 0; r < TP_HINGE_MOTOR_CONSTRAINTS; ++r)
+	{
+		const index_t *order = rorder(m, r);
+		TP_FOR_LANES(l)
+			assert(order[l] == order[0]);
+	}
+#endif
+
+	for(int i = 0; i < num_iterations; ++i)
+	{
+		tp_lanes max_delta;
+		TP_FOR_LANES(l)
+			max_delta[l] = TP_REAL(0.0);
+
+		bool backward = false;
+#ifdef TP_SYMMETRIC_SWEEPS
+		backward = (i % 2);
+#endif
+
+		for(int r = 0; r < num_rows; ++r)
+		{
+			int p = backward ? num_rows - 1 - r : r;
+			index_t s = (p < TP_HINGE_MOTOR_CONSTRAINTS) ? _rorder(m, p) : p;
+
+			index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+			tp_lanes tmp;
+			TP_FOR_LANES(l)
+				tmp[l] = TP_REAL(0.0);
+
+			for(int bi = 1; bi >= stop_at_body; --bi)
+			{
+				const index_t *body = Jm(m, s, bi);
+
+				tp_vec3_lanes _J, _a;
+				tp_lanes dot;
+
+				get_vec3_lanes(tJ(m, s, bi), _J);
+				gather_vec3_lanes(ta(m, 0), stride_a, body, _a);
+				dot_vec3_lanes(dot, _J, _a);
+				TP_FOR_LANES(l)
+					tmp[l] += dot[l];
+
+				get_vec3_lanes(aJ(m, s, bi), _J);
+				gather_vec3_lanes(aa(m, 0), stride_a, body, _a);
+				dot_vec3_lanes(dot, _J, _a);
+				TP_FOR_LANES(l)
+					tmp[l] += dot[l];
+			}
+
+			// Limit lambda, selects instead of the branches of clamp2()
+			real_t *_lambda = lambda(m, s);
+			const real_t *_lambda_min = lambda_min(m, s);
+			const real_t *_lambda_max = lambda_max(m, s);
+			const real_t *_d = d(m, s);
+			const real_t *_rhs = rhs(m, s);
+			const real_t *_relax = relax(m, relax_type(m, s));
+
+			tp_lanes delta_lambda;
+			TP_FOR_LANES(l)
+			{
+				bool invertible = _d[l] > TP_REAL(1e-7) || _d[l] < TP_REAL(-1e-7);
+				real_t dii = invertible ? _d[l] : TP_REAL(1.0);
+				real_t delta = invertible ? _relax[l] * (_rhs[l] - tmp[l]) / dii : TP_REAL(0.0);
+
+				real_t new_lambda = _lambda[l] + delta;
+				new_lambda = (new_lambda > _lambda_max[l]) ? _lambda_max[l] : new_lambda;
+				new_lambda = (new_lambda < _lambda_min[l]) ? _lambda_min[l] : new_lambda;
+
+				delta_lambda[l] = new_lambda - _lambda[l];
+				_lambda[l] += delta_lambda[l];
+
+				real_t abs_delta = TP_ABS(delta_lambda[l]);
+				max_delta[l] = (abs_delta > max_delta[l]) ? abs_delta : max_delta[l];
+			}
+
+			for(int bi = 1; bi >= stop_at_body; --bi)
+			{
+				const index_t *body = Jm(m, s, bi);
+
+				tp_vec3_lanes _B;
+				get_vec3_lanes(tB(m, s, bi), _B);
+				scatter_add_vec3_lanes(_B, delta_lambda, ta(m, 0), stride_a, body);
+
+				get_vec3_lanes(aB(m, s, bi), _B);
+				scatter_add_vec3_lanes(_B, delta_lambda, aa(m, 0), stride_a, body);
+			}
+		}
+
+		real_t block_max_delta = TP_REAL(0.0);
+		TP_FOR_LANES(l)
+			block_max_delta = (max_delta[l] > block_max_delta) ? max_delta[l] : block_max_delta;
+
+		if(block_max_delta < tolerance)
+			return i + 1;
+	}
+
+	return num_iterations;
+}
+
+/** Adds the constraint forces to the external forces of all worlds in a
+ * block, see compute_Fc_add_to_Fe().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		num_rows	Number of rows to process, see num_rows_lanes().
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void compute_Fc_add_to_Fe_lanes(struct mem_t *m, int num_rows)
+{
+	const ptrdiff_t stride_Fe = tFe(m, 1) - tFe(m, 0);
+
+	for(int s = 0; s < num_rows; ++s)
+	{
+		index_t stop_at_body = (s < TP_HINGE_MOTOR_CONSTRAINTS) ? 0 : 1;
+
+		for(int bi = 1; bi >= stop_at_body; --bi)
+		{
+			const index_t *body = Jm(m, s, bi);
+
+			tp_vec3_lanes _J;
+			get_vec3_lanes(tJ(m, s, bi), _J);
+			scatter_add_vec3_lanes(_J, lambda(m, s), tFe(m, 0), stride_Fe, body);
+
+			get_vec3_lanes(aJ(m, s, bi), _J);
+			scatter_add_vec3_lanes(_J, lambda(m, s), aFe(m, 0), stride_Fe, body);
+		}
+	}
+}
+
+/** Integrates all worlds in a block with semi-implicit Euler, see step_world().
+ *
+ * @param		m			Handle of lane 0 of the block.
+ * @param		dt			Size of timestep (seconds).
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES_INLINE
+void integrate_lanes(struct mem_t *m, real_t dt)
+{
+	tp_vec3_lanes zero;
+	for(int k = 0; k < 3; ++k)
+	{
+		TP_FOR_LANES(l)
+			zero[k][l] = TP_REAL(0.0);
+	}
+
+	for(int i = 0; i < (TP_BODIES); ++i)
+	{
+		const real_t *_mi = mi(m, i);
+
+		// Velocity update, translational ---------------------------
+		tp_vec3_lanes _tFe, _vel;
+		get_vec3_lanes(tFe(m, i), _tFe);
+		get_vec3_lanes(vel(m, i), _vel);
+
+		for(int k = 0; k < 3; ++k)
+		{
+			TP_FOR_LANES(l)
+				_vel[k][l] += dt * _mi[l] * _tFe[k][l];
+		}
+		set_vec3_lanes(_vel, vel(m, i));
+
+		// Velocity update, rotational ------------------------------
+		tp_mtx33_lanes _Iwi;
+		get_mtx33_lanes(Iwi(m, i), _Iwi);
+
+		tp_vec3_lanes _aFe, Iwi_aFe, _omega;
+		get_vec3_lanes(aFe(m, i), _aFe);
+		mult_mtx33_vec3_lanes(Iwi_aFe, _Iwi, _aFe);
+		get_vec3_lanes(omega(m, i), _omega);
+
+		for(int k = 0; k < 3; ++k)
+		{
+			TP_FOR_LANES(l)
+				_omega[k][l] += dt * Iwi_aFe[k][l];
+		}
+		set_vec3_lanes(_omega, omega(m, i));
+
+		// Position update, translational ---------------------------
+		tp_vec3_lanes _pos;
+		get_vec3_lanes(pos(m, i), _pos);
+
+		for(int k = 0; k < 3; ++k)
+		{
+			TP_FOR_LANES(l)
+				_pos[k][l] += dt * _vel[k][l];
+		}
+		set_vec3_lanes(_pos, pos(m, i));
+
+		// Position update, rotational ------------------------------
+		tp_quatern_lanes _quatern, dq;
+		get_quatern_lanes(quatern(m, i), _quatern);
+		mult_omega_quatern_lanes(dq, _omega, _quatern);
+
+		for(int k = 0; k < 4; ++k)
+		{
+			TP_FOR_LANES(l)
+				_quatern[k][l] += dt * TP_REAL(0.5) * dq[k][l];
+		}
+		normalize_quaternion_lanes(_quatern);
+		set_quatern_lanes(_quatern, quatern(m, i));
+
+		tp_mtx33_lanes _R;
+		quaternion_to_rot_mtx33_lanes(_quatern, _R);
+		set_mtx33_lanes(_R, R(m, i));
+
+		// Zero external force for next step ------------------------
+		set_vec3_lanes(zero, tFe(m, i));
+		set_vec3_lanes(zero, aFe(m, i));
+	}
+
+}
+
+/** Steps all worlds of a block a dt amount of seconds.
+ *
+ * Gives the same result as calling step_world() for every lane of the block,
+ * up to rounding, when step_world() solves by Projected Gauss-Seidel one row at a
+ * time. The solvers selected by #TP_BLOCK_HINGES, #TP_TREE_SOLVER, #TP_NNCG and
+ * #TP_MIXED_PRECISION are not used by the lanes, see solve_for_lambda_lanes(). The
+ * worlds of a block must share the row order, see order_rows(). As for
+ * step_world(), the kinematics cache must be up to date,
+ * see update_kinematics(). The function is compiled for several instruction sets and
+ * the one matching the CPU is picked at load time, see #TP_FUNC_LANES.
+ *
+ * @param		block			The block of worlds.
+ * @param		dt				Size of timestep (seconds).
+ * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+ * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+ * @return the number of solver iterations run.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_LANES
+int step_block(struct mem_block_t *block, real_t dt, int num_iterations, real_t tolerance = TP_REAL(0.0))
+{
+	struct mem_t lane0;
+	lane0.block = block;
+	lane0.lane = 0;
+
+	struct mem_t *m = &lane0;
+
+	const int num_rows = num_rows_lanes(m);
+
+	// Update Jacobian for constraints (hinges)
+	update_jacobian_lanes(m);
+
+	// Compute contraint+contact lambdas
+	int iterations = solve_for_lambda_lanes(m, num_rows, dt, num_iterations, tolerance);
+
+	// Add constraint+contact forces to external forces
+	compute_Fc_add_to_Fe_lanes(m, num_rows);
+
+	#ifdef TP_DEBUG
+	for(int l = 0; l < (int)(TP_LANES); ++l)
+	{
+		struct mem_t world;
+		world.block = block;
+		world.lane = l;
+		compute_Fc(&world);
+	}
+	#endif
+
+	// Integrate with semi-implicit Euler
+	integrate_lanes(m, dt);
+
+	// Zero the active contact rows, and make them inactive
+	tp_vec3_lanes zero;
+	for(int k = 0; k < 3; ++k)
+	{
+		TP_FOR_LANES(l)
+			zero[k][l] = TP_REAL(0.0);
+	}
+
+	for(int s = TP_HINGE_MOTOR_CONSTRAINTS; s < num_rows; ++s)
+	{
+		set_vec3_lanes(zero, tJ(m, s, 1));
+		set_vec3_lanes(zero, aJ(m, s, 1));
+	}
+
+	index_t *_ncrows = ncrows(m);
+	TP_FOR_LANES(l)
+		_ncrows[l] = 0;
+
+	// World inertia, anchors and axes for the new rotations
+	update_kinematics_lanes(m);
+
+	return iterations;
+}
+
+//@}
@@ -0,0 +1,309 @@
+/*
+ * tree_solver.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+/**
+ * @name Tree Solver Functions
+ *
+ * The hinge rows are solved exactly in time linear in the number of bodies, by
+ * the method presented in:
+ *
+ * D. Baraff. Linear-time dynamics using Lagrange multipliers. In SIGGRAPH, pages 137–146, 1996.
+ *
+ * The bodies and the hinges are the nodes of a graph with an edge between every
+ * hinge and its two bodies. If the graph is a forest, the matrix
+ * \f[
+ * 	H = \left[\begin{array}{cc} M & J_h^{\mathrm{T}} \\ J_h & 0 \end{array}\right]
+ * \f]
+ * is factored without fill-in by eliminating the nodes from the leaves to the
+ * roots. Here \f$J_h\f$ are the hinge rows of the Jacobian. The order of the nodes
+ * depends only on the hinges, and is kept in the memory of the world, see
+ * order_tree(). The factors are kept in a struct tree_t, which lives in the struct
+ * sweep_t of one solve, see prepare_sweep().
+ *
+ * Only available if #TP_TREE_SOLVER is defined.
+ */
+//@{
+
+/** Number of nodes of the tree, the bodies followed by the hinges.
+ * @ingroup tp-dynamics
+ */
+#define TP_TREE_NODES ((TP_BODIES)+(TP_HINGES))
+
+/** Factorization of the tree, see factor_tree().
+ * @ingroup tp-dynamics
+ */
+struct tree_t
+{
+	real_t Di[TP_TREE_NODES*36];		// D_i^{-1}
+	real_t Jt[TP_TREE_NODES*36];		// D_i^{-1} H_{i,parent}
+	real_t x[TP_TREE_NODES*6];			// Right hand side and solution, for solving
+};
+
+/** Returns the number of rows of a tree node, 6 for bodies and 5 for hinges.
+ *
+ * @param		node		Node to query, in interval [0, #TP_TREE_NODES-1].
+ * @return the number of rows.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+int tree_node_size(int node)
+{
+	return (node < (TP_BODIES)) ? 6 : 5;
+}
+
+/** Computes the block of \f$H\f$ between a node and its parent.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		node		Child node.
+ * @param		parent		Parent node.
+ * @param[out]	block		Row major block of size tree_node_size(node) x tree_node_size(parent).
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC_INLINE
+void tree_block(struct mem_t *m, int node, int parent, real_t *block)
+{
+	bool hinge_child = (node >= (TP_BODIES));
+	int h = hinge_child ? node - (TP_BODIES) : parent - (TP_BODIES);
+	int body = hinge_child ? parent : node;
+
+	int bi = (_Jm(m, 5*h, 0) == body) ? 0 : 1;
+
+	for(int k = 0; k < 5; ++k)
+	{
+		tp_vec3 _tJ;
+		get_row_tJ(m, 5*h+k, bi, _tJ);
+
+		real_t row[6];
+		row[0] = _tJ[0];
+		row[1] = _tJ[1];
+		row[2] = _tJ[2];
+		row[3] = _x(aJ(m, 5*h+k, bi));
+		row[4] = _y(aJ(m, 5*h+k, bi));
+		row[5] = _z(aJ(m, 5*h+k, bi));
+
+		// The hinge rows of J, or their transpose
+		for(int c = 0; c < 6; ++c)
+		{
+			if(hinge_child)
+				block[k*6+c] = row[c];
+			else
+				block[c*5+k] = row[c];
+		}
+	}
+}
+
+/** Factors \f$H\f$ in the order of the tree nodes, see order_tree().
+ *
+ * The factorization is \f$D_i = H_{ii} - \sum_j H_{ji}^{\mathrm{T}} D_j^{-1} H_{ji}\f$,
+ * summing over the children \f$j\f$ of node \f$i\f$. The world inverse inertias
+ * must be up to date, see update_kinematics(). A body of infinite mass, with zero
+ * inverse mass, is fixed, and \f$D_i^{-1}\f$ is zero for it.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param[out]	tree		The factorization.
+ * @return @b true if successful, @b false if the hinges form a loop or a block is singular.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+bool factor_tree(struct mem_t *m, struct tree_t *tree)
+{
+	// The order of the nodes is kept by create_hinge()
+	if(_tnode(m, 0) < 0) return false;
+
+	// Diagonal blocks, M for bodies and zero for hinges
+	for(int i = 0; i < TP_TREE_NODES*36; ++i) tree->Di[i] = TP_REAL(0.0);
+
+	for(int b = 0; b < (TP_BODIES); ++b)
+	{
+		if(_mi(m, b) == TP_REAL(0.0)) continue;
+
+		real_t *D = tree->Di + b*36;
+
+		real_t _Iwi[9], Iw[9];
+		for(int r = 0; r < 3; ++r)
+			for(int c = 0; c < 3; ++c)
+				_Iwi[r*3+c] = _ij(Iwi(m, b), r, c);
+
+		if(!invert_mtxn(Iw, _Iwi, 3)) return false;
+
+		for(int k = 0; k < 3; ++k)
+			D[k*6+k] = TP_REAL(1.0) / _mi(m, b);
+
+		for(int r = 0; r < 3; ++r)
+			for(int c = 0; c < 3; ++c)
+				D[(3+r)*6+3+c] = Iw[r*3+c];
+	}
+
+	// Eliminate from the leaves to the roots
+	for(int q = TP_TREE_NODES-1; q >= 0; --q)
+	{
+		int i = _tnode(m, q);
+		int ni = tree_node_size(i);
+
+		// A fixed body moves neither its parent nor its children, D_i^{-1} = 0
+		if(i < (TP_BODIES) && _mi(m, i) == TP_REAL(0.0))
+		{
+			for(int k = 0; k < 36; ++k) tree->Di[i*36+k] = TP_REAL(0.0);
+		}
+		else
+		{
+			real_t D[36];
+			for(int k = 0; k < ni*ni; ++k) D[k] = tree->Di[i*36+k];
+
+			if(!invert_mtxn(tree->Di + i*36, D, ni)) return false;
+		}
+
+		int p = _tparent(m, i);
+		if(p < 0) continue;
+
+		int np = tree_node_size(p);
+
+		real_t Hip[36];
+		tree_block(m, i, p, Hip);
+
+		// Jt_i = D_i^{-1} H_{ip}
+		real_t *Jt = tree->Jt + i*36;
+		for(int r = 0; r < ni; ++r)
+		{
+			for(int c = 0; c < np; ++c)
+			{
+				real_t sum = TP_REAL(0.0);
+				for(int k = 0; k < ni; ++k) sum += tree->Di[i*36+r*ni+k] * Hip[k*np+c];
+				Jt[r*np+c] = sum;
+			}
+		}
+
+		// D_p -= H_{ip}^T Jt_i
+		for(int r = 0; r < np; ++r)
+		{
+			for(int c = 0; c < np; ++c)
+			{
+				real_t sum = TP_REAL(0.0);
+				for(int k = 0; k < ni; ++k) sum += Hip[k*np+r] * Jt[k*np+c];
+				tree->Di[p*36+r*np+c] -= sum;
+			}
+		}
+	}
+
+	return true;
+}
+
+/** Solves all hinge rows exactly, one block Gauss-Seidel step.
+ *
+ * Computes \f$\Delta \lambda_h = \omega (J_h B_h)^{-1}(rhs_h - J_h a)\f$ for the hinge rows
+ * with the factorization of factor_tree(), and updates \f$a\f$.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		tree		The factorization.
+ * @return the largest change \f$|\Delta \lambda_i|\f$ of the rows.
+ *
+ * @ingroup tp-dynamics
+ */
+TP_FUNC
+real_t solve_tree(struct mem_t *m, struct tree_t *tree)
+{
+	// Right hand side, zero for bodies and the residuals for hinges
+	for(int i = 0; i < (TP_BODIES)*6; ++i) tree->x[i] = TP_REAL(0.0);
+
+	for(int s = 0; s < TP_HINGE_CONSTRAINTS; ++s)
+	{
+		real_t tmp = TP_REAL(0.0);
+		for(int bi = 1; bi >= 0; --bi)
+		{
+			index_t body = _Jm(m, s, bi);
+
+			tp_vec3 _tJ, _ta;
+			get_row_tJ(m, s, bi, _tJ);
+			get_vec3(ta(m, body), _ta);
+			tmp += dot_vec3(_tJ, _ta);
+
+			tp_vec3 _aJ, _aa;
+			get_vec3(aJ(m, s, bi), _aJ);
+			get_vec3(aa(m, body), _aa);
+			tmp += dot_vec3(_aJ, _aa);
+		}
+
+		tree->x[(TP_BODIES)*6 + (s/5)*6 + s%5] = _rhs(m, s) - tmp;
+	}
+
+	// Leaves to roots, x_p -= Jt_i^T x_i
+	for(int q = TP_TREE_NODES-1; q >= 0; --q)
+	{
+		int i = _tnode(m, q);
+		int p = _tparent(m, i);
+		if(p < 0) continue;
+
+		int ni = tree_node_size(i);
+		int np = tree_node_size(p);
+
+		for(int c = 0; c < np; ++c)
+			for(int k = 0; k < ni; ++k)
+				tree->x[p*6+c] -= tree->Jt[i*36+k*np+c] * tree->x[i*6+k];
+	}
+
+	// Roots to leaves, x_i = D_i^{-1} x_i - Jt_i x_p
+	for(int q = 0; q < TP_TREE_NODES; ++q)
+	{
+		int i = _tnode(m, q);
+		int ni = tree_node_size(i);
+
+		real_t xi[6];
+		for(int r = 0; r < ni; ++r)
+		{
+			xi[r] = TP_REAL(0.0);
+			for(int k = 0; k < ni; ++k) xi[r] += tree->Di[i*36+r*ni+k] * tree->x[i*6+k];
+		}
+
+		int p = _tparent(m, i);
+		if(p >= 0)
+		{
+			int np = tree_node_size(p);
+			for(int r = 0; r < ni; ++r)
+				for(int k = 0; k < np; ++k)
+					xi[r] -= tree->Jt[i*36+r*np+k] * tree->x[p*6+k];
+		}
+
+		for(int r = 0; r < ni; ++r) tree->x[i*6+r] = xi[r];
+	}
+
+	// The hinge part of the solution is -\Delta\lambda
+	real_t max_delta = TP_REAL(0.0);
+	for(int s = 0; s < TP_HINGE_CONSTRAINTS; ++s)
+	{
+		real_t delta_lambda = -_relax(m, TP_RELAX_HINGE) * tree->x[(TP_BODIES)*6 + (s/5)*6 + s%5];
+
+		*lambda(m, s) += delta_lambda;
+
+		if(TP_ABS(delta_lambda) > max_delta)
+			max_delta = TP_ABS(delta_lambda);
+
+		for(int bi = 1; bi >= 0; --bi)
+		{
+			index_t body = _Jm(m, s, bi);
+
+			tp_vec3 _tB;
+			get_row_tB(m, s, bi, _tB);
+
+			*x(ta(m, body)) += delta_lambda * _tB[0];
+			*y(ta(m, body)) += delta_lambda * _tB[1];
+			*z(ta(m, body)) += delta_lambda * _tB[2];
+
+			*x(aa(m, body)) += delta_lambda * _x(aB(m, s, bi));
+			*y(aa(m, body)) += delta_lambda * _y(aB(m, s, bi));
+			*z(aa(m, body)) += delta_lambda * _z(aB(m, s, bi));
+		}
+	}
+
+	return max_delta;
+}
+
+//@}
@@ -0,0 +1,667 @@
+/*
+ * dynamic.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+/* The memory layout. The same as simple.h, but the size of the model is set
+ * at runtime, see init_memory(), and the arrays point into one block of
+ * storage. TP_BODIES, TP_HINGES, TP_MOTORS and TP_FEET read the size from the
+ * world, m.
+ */
+struct mem_t
+{
+	int bodies;												// Model size
+	int hinges;
+	int motors;
+	int feet;
+
+	real_t *q;												// Generalized position variable, pos + quatern
+	real_t *v;												// Generalized velocity variable, vel + omega
+	real_t *mi;												// Inverse mass
+	real_t *Ibi;											// Inverse inertia matrix
+	real_t *R;												// Convenience matrix
+	real_t *Iwi;											// Inverse inertia matrix, world frame
+
+	real_t *Fe;												// External force
+
+	real_t *J;												// Constraint Jacobian
+
+	real_t *lambda;											// F_c = J^{T}\lambda
+	real_t *lambda_min;										// min
+	real_t *lambda_max;										// max
+
+	index_t *mm;											// Mapping motors->hinges
+	index_t *rorder;										// Solver order of hinge and motor rows
+	real_t *mdspeed;										// Desired speed for motors
+	real_t relax[3];										// Relaxation factors of hinge, motor and contact rows
+	real_t *iniq;											// Quaternions for initial rotations
+
+	index_t *Jm;											// Mapping->bodies, sparse Jacobian
+	index_t *crows;											// Active contact rows
+	index_t ncrows;											// Number of active contact rows
+	real_t *B;												// M^{-1}J^{T}, for solving
+	real_t *a;												// B\lambda, for solving
+	real_t *d;												// diag(JB), for solving
+	real_t *di;												// 1/diag(JB), for solving
+	real_t *rhs;											// Right hand side, for solving
+#ifdef TP_BLOCK_HINGES
+	real_t *Hi;												// (JB)^{-1} of hinge row blocks, for solving
+#endif
+
+	real_t *haxes;											// Hinge axis 1+2, tangent base 1
+	real_t *hanchors;										// Hinge anchors ( -''- )
+	real_t *haxes_w;										// Hinge axis 1+2, world frame
+	real_t *hanchors_w;										// Hinge anchors, world frame
+
+#ifdef TP_DEBUG
+	real_t *Fc;												// Constraint force
+	real_t *cinfo;											// Contact points + contact normals
+	real_t *cplane;											// Contact plane (axes where slip is eliminated)
+	index_t *cbody;											// Body indexes connected to feet
+#endif
+
+	char *scratch;											// Local arrays of the solver, see push_scratch()
+	size_t scratch_size;
+	size_t scratch_used;
+};
+
+TP_FUNC_INLINE
+void zero_memory(struct mem_t *m)
+{
+	for(int i = 0; i < (TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4); ++i) m->q[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) m->v[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES); ++i) m->mi[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) m->Ibi[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) m->R[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) m->Iwi[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) m->Fe[i] = TP_REAL(0.0);
+	for(int i = 0; i < TP_JACOBIAN_SIZE; ++i) m->J[i] = TP_REAL(0.0);
+
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->lambda[i] = TP_REAL(0.0);
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->lambda_min[i] = TP_REAL(-1048576.0);
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->lambda_max[i] = TP_REAL(1048576.0);
+
+	for(int i = 0; i < 2*TP_CONSTRAINTS; ++i) m->Jm[i] = 0;
+	for(int i = 0; i < TP_CONTACT_CONSTRAINTS*(TP_FEET); ++i) m->crows[i] = 0;
+	m->ncrows = 0;
+	for(int i = 0; i < TP_JACOBIAN_SIZE; ++i) m->B[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) m->a[i] = TP_REAL(0.0);
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->d[i] = TP_REAL(0.0);
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->di[i] = TP_REAL(0.0);
+	for(int i = 0; i < TP_CONSTRAINTS; ++i) m->rhs[i] = TP_REAL(0.0);
+#ifdef TP_BLOCK_HINGES
+	for(int i = 0; i < (TP_HINGES)*25; ++i) m->Hi[i] = TP_REAL(0.0);
+#endif
+	for(int i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) m->hanchors[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) m->hanchors_w[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) m->haxes_w[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_HINGES)*2*TP_SIZE_VEC6; ++i) m->haxes[i] = TP_REAL(0.0);
+
+	for(int i = 0; i < (TP_MOTORS); ++i) m->mm[i] = 0;
+	for(int i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) m->rorder[i] = i;
+	for(int i = 0; i < (TP_MOTORS); ++i) m->mdspeed[i] = TP_REAL(0.0);
+	for(int i = 0; i < 3; ++i) m->relax[i] = TP_REAL(1.0);
+	for(int i = 0; i < (TP_HINGES)*TP_SIZE_VEC4; ++i) m->iniq[i] = TP_REAL(0.0);
+
+#ifdef TP_DEBUG
+	for(int i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) m->Fc[i] = TP_REAL(0.0);
+	for(int i = 0; i < 3*(TP_FEET)*TP_SIZE_VEC6; ++i) m->cinfo[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_FEET)*TP_SIZE_VEC6; ++i) m->cplane[i] = TP_REAL(0.0);
+	for(int i = 0; i < (TP_FEET); ++i) m->cbody[i] = 0;
+#endif
+}
+
+// Places an array of a world in its storage, see layout_memory()
+TP_FUNC_INLINE
+void * place_array(char *storage, size_t *used, size_t bytes)
+{
+	void *array = storage ? storage + *used : 0;
+	*used += (bytes + 63) & ~(size_t)63;
+	return array;
+}
+
+// Points the arrays of a world into its storage, and returns the size of the storage
+TP_FUNC_INLINE
+size_t layout_memory(struct mem_t *m, char *storage)
+{
+	size_t used = 0;
+
+	m->q = (real_t *)place_array(storage, &used, (TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4)*sizeof(real_t));
+	m->v = (real_t *)place_array(storage, &used, (TP_BODIES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->mi = (real_t *)place_array(storage, &used, (TP_BODIES)*sizeof(real_t));
+	m->Ibi = (real_t *)place_array(storage, &used, (TP_BODIES)*3*TP_SIZE_VEC3*sizeof(real_t));
+	m->R = (real_t *)place_array(storage, &used, (TP_BODIES)*3*TP_SIZE_VEC3*sizeof(real_t));
+	m->Iwi = (real_t *)place_array(storage, &used, (TP_BODIES)*3*TP_SIZE_VEC3*sizeof(real_t));
+	m->Fe = (real_t *)place_array(storage, &used, (TP_BODIES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->J = (real_t *)place_array(storage, &used, TP_JACOBIAN_SIZE*sizeof(real_t));
+	m->lambda = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+	m->lambda_min = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+	m->lambda_max = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+	m->mm = (index_t *)place_array(storage, &used, (TP_MOTORS)*sizeof(index_t));
+	m->rorder = (index_t *)place_array(storage, &used, TP_HINGE_MOTOR_CONSTRAINTS*sizeof(index_t));
+	m->mdspeed = (real_t *)place_array(storage, &used, (TP_MOTORS)*sizeof(real_t));
+	m->iniq = (real_t *)place_array(storage, &used, (TP_HINGES)*TP_SIZE_VEC4*sizeof(real_t));
+	m->Jm = (index_t *)place_array(storage, &used, 2*TP_CONSTRAINTS*sizeof(index_t));
+	m->crows = (index_t *)place_array(storage, &used, TP_CONTACT_CONSTRAINTS*(TP_FEET)*sizeof(index_t));
+	m->B = (real_t *)place_array(storage, &used, TP_JACOBIAN_SIZE*sizeof(real_t));
+	m->a = (real_t *)place_array(storage, &used, (TP_BODIES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->d = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+	m->di = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+	m->rhs = (real_t *)place_array(storage, &used, TP_CONSTRAINTS*sizeof(real_t));
+#ifdef TP_BLOCK_HINGES
+	m->Hi = (real_t *)place_array(storage, &used, (TP_HINGES)*25*sizeof(real_t));
+#endif
+	m->haxes = (real_t *)place_array(storage, &used, (TP_HINGES)*2*TP_SIZE_VEC6*sizeof(real_t));
+	m->hanchors = (real_t *)place_array(storage, &used, (TP_HINGES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->haxes_w = (real_t *)place_array(storage, &used, (TP_HINGES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->hanchors_w = (real_t *)place_array(storage, &used, (TP_HINGES)*TP_SIZE_VEC6*sizeof(real_t));
+#ifdef TP_DEBUG
+	m->Fc = (real_t *)place_array(storage, &used, (TP_BODIES)*TP_SIZE_VEC6*sizeof(real_t));
+	m->cinfo = (real_t *)place_array(storage, &used, 3*(TP_FEET)*TP_SIZE_VEC6*sizeof(real_t));
+	m->cplane = (real_t *)place_array(storage, &used, (TP_FEET)*TP_SIZE_VEC6*sizeof(real_t));
+	m->cbody = (index_t *)place_array(storage, &used, (TP_FEET)*sizeof(index_t));
+#endif
+
+	// step_world_adaptive() holds its bodies, multipliers and contact rows across step_world(),
+	// whose solvers hold at most 2*TP_BODIES vectors or 2*TP_CONSTRAINTS reals at a time
+	size_t scratch = (TP_BODIES)*(6*sizeof(tp_vec3) + sizeof(tp_quatern) + sizeof(tp_mtx33))
+			+ TP_CONSTRAINTS*sizeof(real_t)
+			+ TP_CONTACT_CONSTRAINTS*(TP_FEET)*(2*sizeof(tp_vec3) + 2*sizeof(real_t))
+			+ 2*(TP_BODIES)*sizeof(tp_vec3) + 2*TP_CONSTRAINTS*sizeof(real_t)
+			+ 8*64;
+	m->scratch_size = (scratch + 63) & ~(size_t)63;
+	m->scratch = (char *)place_array(storage, &used, m->scratch_size);
+
+	return used;
+}
+
+/** Takes a local array from the scratch space of a world, instead of the stack.
+ * The arrays are released in reverse order, see pop_scratch().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		bytes		Size of the array.
+ * @return the array, aligned to 64 bytes.
+ *
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE
+void * push_scratch(struct mem_t *m, size_t bytes)
+{
+	void *array = place_array(m->scratch, &m->scratch_used, bytes);
+	assert(m->scratch_used <= m->scratch_size);
+	return array;
+}
+
+/** Releases a local array taken by push_scratch(), and every array taken after it.
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		array		The array.
+ *
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE
+void pop_scratch(struct mem_t *m, void *array)
+{
+	m->scratch_used = (char *)array - m->scratch;
+}
+
+// Local arrays sized by the model, in the scratch space of the world, m
+#define TP_SCRATCH_ARRAY(type, name, size)	type *name = (type *)push_scratch(m, (size)*sizeof(type))
+#define TP_RELEASE_SCRATCH(name)			pop_scratch(m, name)
+
+/** Returns the size of the storage of a world, see init_memory().
+ *
+ * @param		bodies		Number of bodies.
+ * @param		hinges		Number of hinges.
+ * @param		motors		Number of motors.
+ * @param		feet		Number of feet.
+ * @return the size in bytes.
+ *
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE
+size_t size_memory(int bodies, int hinges, int motors, int feet)
+{
+	struct mem_t model;
+	model.bodies = bodies;
+	model.hinges = hinges;
+	model.motors = motors;
+	model.feet = feet;
+
+	return layout_memory(&model, 0);
+}
+
+/** Sets the size of a world, points its arrays into its storage, and zero
+ * initializes it, see zero_memory().
+ *
+ * @param		m			Pointer to the memory representing the simulation world.
+ * @param		storage		Storage of size_memory() bytes, aligned to 64 bytes.
+ * @param		bodies		Number of bodies.
+ * @param		hinges		Number of hinges.
+ * @param		motors		Number of motors.
+ * @param		feet		Number of feet.
+ *
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE
+void init_memory(struct mem_t *m, void *storage, int bodies, int hinges, int motors, int feet)
+{
+	m->bodies = bodies;
+	m->hinges = hinges;
+	m->motors = motors;
+	m->feet = feet;
+
+	layout_memory(m, (char *)storage);
+	m->scratch_used = 0;
+	zero_memory(m);
+}
+
+TP_FUNC_INLINE real_t * x(real_t *vec3)
+{
+	return vec3;
+}
+
+TP_FUNC_INLINE real_t _x(const real_t *vec3)
+{
+	return vec3[0];
+}
+
+TP_FUNC_INLINE real_t * y(real_t *vec3)
+{
+	return vec3+1;
+}
+
+TP_FUNC_INLINE real_t _y(const real_t *vec3)
+{
+	return vec3[1];
+}
+
+TP_FUNC_INLINE real_t * z(real_t *vec3)
+{
+	return vec3+2;
+}
+
+TP_FUNC_INLINE real_t _z(const real_t *vec3)
+{
+	return vec3[2];
+}
+
+TP_FUNC_INLINE real_t * q0(real_t *quatern)
+{
+	return quatern;
+}
+
+TP_FUNC_INLINE real_t _q0(const real_t *quatern)
+{
+	return quatern[0];
+}
+
+TP_FUNC_INLINE real_t * q1(real_t *quatern)
+{
+	return quatern+1;
+}
+
+TP_FUNC_INLINE real_t _q1(const real_t *quatern)
+{
+	return quatern[1];
+}
+
+TP_FUNC_INLINE real_t * q2(real_t *quatern)
+{
+	return quatern+2;
+}
+
+TP_FUNC_INLINE real_t _q2(const real_t *quatern)
+{
+	return quatern[2];
+}
+
+TP_FUNC_INLINE real_t * q3(real_t *quatern)
+{
+	return quatern+3;
+}
+
+TP_FUNC_INLINE real_t _q3(const real_t *quatern)
+{
+	return quatern[3];
+}
+
+TP_FUNC_INLINE real_t * ij(real_t *mtx33, index_t row, index_t col)
+{
+	return mtx33 + row*TP_SIZE_VEC3 + col;
+}
+
+TP_FUNC_INLINE real_t _ij(const real_t *mtx33, index_t row, index_t col)
+{
+	return *(mtx33 + row*TP_SIZE_VEC3 + col);
+}
+
+TP_FUNC_INLINE real_t * haxis(struct mem_t *m, index_t hinge_num)
+{
+	return m->haxes + hinge_num*2*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * haxis_num(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->haxes + hinge_num*2*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * ht0(struct mem_t *m, index_t hinge_num)
+{
+	return m->haxes + hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * ht1(struct mem_t *m, index_t hinge_num)
+{
+	return m->haxes + hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * hanchor(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->hanchors + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * haxis_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->haxes_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * hanchor_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->hanchors_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * pos(struct mem_t *m, index_t body)
+{
+	return m->q + body*(TP_SIZE_VEC3+TP_SIZE_VEC4);
+}
+
+TP_FUNC_INLINE real_t * vel(struct mem_t *m, index_t body)
+{
+	return m->v + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * omega(struct mem_t *m, index_t body)
+{
+	return m->v + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * quatern(struct mem_t *m, index_t body)
+{
+	return m->q + body*(TP_SIZE_VEC3+TP_SIZE_VEC4) + TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * mi(struct mem_t *m, index_t body)
+{
+	return m->mi + body;
+}
+TP_FUNC_INLINE real_t _mi(struct mem_t *m, index_t body)
+{
+	return *(m->mi + body);
+}
+
+TP_FUNC_INLINE real_t * R(struct mem_t *m, index_t body)
+{
+	return m->R + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * Ibi(struct mem_t *m, index_t body)
+{
+	return m->Ibi + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * Iwi(struct mem_t *m, index_t body)
+{
+	return m->Iwi + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * tFe(struct mem_t *m, index_t body)
+{
+	return m->Fe + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aFe(struct mem_t *m, index_t body)
+{
+	return m->Fe + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE index_t * Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->Jm + constraint*2 + body;
+}
+
+TP_FUNC_INLINE index_t _Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return *(m->Jm + constraint*2 + body);
+}
+
+TP_FUNC_INLINE index_t * crow(struct mem_t *m, index_t num)
+{
+	return m->crows + num;
+}
+
+TP_FUNC_INLINE index_t _crow(struct mem_t *m, index_t num)
+{
+	return *(m->crows + num);
+}
+
+TP_FUNC_INLINE index_t * ncrows(struct mem_t *m)
+{
+	return &m->ncrows;
+}
+
+TP_FUNC_INLINE index_t _ncrows(struct mem_t *m)
+{
+	return m->ncrows;
+}
+
+TP_FUNC_INLINE real_t * tJ(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tJ()
+	return m->J + constraint*(TP_SIZE_VEC6);
+#else
+	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
+}
+
+TP_FUNC_INLINE real_t * aJ(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	return m->J + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
+	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6) + 3;
+#endif
+}
+
+TP_FUNC_INLINE real_t * tB(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tB()
+	return m->B + constraint*(TP_SIZE_VEC6);
+#else
+	return m->B + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
+}
+
+TP_FUNC_INLINE real_t * aB(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	return m->B + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
+	return m->B + (constraint*2 + body)*(TP_SIZE_VEC6)+3;
+#endif
+}
+
+TP_FUNC_INLINE real_t * ta(struct mem_t *m, index_t body)
+{
+	return m->a + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aa(struct mem_t *m, index_t body)
+{
+	return m->a + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * lambda(struct mem_t *m, index_t constraint)
+{
+	return m->lambda + constraint;
+}
+
+TP_FUNC_INLINE real_t _lambda(struct mem_t *m, index_t constraint)
+{
+	return *(m->lambda + constraint);
+}
+
+TP_FUNC_INLINE real_t * lambda_min(struct mem_t *m, index_t constraint)
+{
+	return m->lambda_min + constraint;
+}
+
+TP_FUNC_INLINE real_t _lambda_min(struct mem_t *m, index_t constraint)
+{
+	return *(m->lambda_min + constraint);
+}
+
+TP_FUNC_INLINE real_t * lambda_max(struct mem_t *m, index_t constraint)
+{
+	return m->lambda_max + constraint;
+}
+
+TP_FUNC_INLINE real_t _lambda_max(struct mem_t *m, index_t constraint)
+{
+	return *(m->lambda_max + constraint);
+}
+
+TP_FUNC_INLINE real_t * d(struct mem_t *m, index_t constraint)
+{
+	return m->d + constraint;
+}
+
+TP_FUNC_INLINE real_t _d(struct mem_t *m, index_t constraint)
+{
+	return *(m->d + constraint);
+}
+
+TP_FUNC_INLINE real_t * di(struct mem_t *m, index_t constraint)
+{
+	return m->di + constraint;
+}
+
+TP_FUNC_INLINE real_t _di(struct mem_t *m, index_t constraint)
+{
+	return *(m->di + constraint);
+}
+
+TP_FUNC_INLINE real_t * rhs(struct mem_t *m, index_t constraint)
+{
+	return m->rhs + constraint;
+}
+
+TP_FUNC_INLINE real_t _rhs(struct mem_t *m, index_t constraint)
+{
+	return *(m->rhs + constraint);
+}
+
+#ifdef TP_BLOCK_HINGES
+TP_FUNC_INLINE real_t * Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return m->Hi + hinge*25 + row*5 + col;
+}
+
+TP_FUNC_INLINE real_t _Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return *(m->Hi + hinge*25 + row*5 + col);
+}
+#endif
+
+TP_FUNC_INLINE real_t * mds(struct mem_t *m, index_t motor)
+{
+	return m->mdspeed + motor;
+}
+
+TP_FUNC_INLINE real_t _mds(struct mem_t *m, index_t motor)
+{
+	return *(m->mdspeed + motor);
+}
+
+TP_FUNC_INLINE real_t * relax(struct mem_t *m, index_t type)
+{
+	return m->relax + type;
+}
+
+TP_FUNC_INLINE real_t _relax(struct mem_t *m, index_t type)
+{
+	return *(m->relax + type);
+}
+
+TP_FUNC_INLINE index_t * mm(struct mem_t *m, index_t motor)
+{
+	return m->mm + motor;
+}
+
+TP_FUNC_INLINE index_t _mm(struct mem_t *m, index_t motor)
+{
+	return *(m->mm + motor);
+}
+
+TP_FUNC_INLINE index_t * rorder(struct mem_t *m, index_t row)
+{
+	return m->rorder + row;
+}
+
+TP_FUNC_INLINE index_t _rorder(struct mem_t *m, index_t row)
+{
+	return *(m->rorder + row);
+}
+
+TP_FUNC_INLINE real_t * iniquatern(struct mem_t *m, index_t hinge_num)
+{
+	return m->iniq + hinge_num*TP_SIZE_VEC4;
+}
+
+#ifdef TP_DEBUG
+TP_FUNC_INLINE real_t * tFc(struct mem_t *m, index_t body)
+{
+	return m->Fc + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aFc(struct mem_t *m, index_t body)
+{
+	return m->Fc + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * cpo(struct mem_t *m, index_t contact)
+{
+	return m->cinfo + contact*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * cno(struct mem_t *m, index_t contact)
+{
+	return m->cinfo + contact*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * cpl0(struct mem_t *m, index_t foot)
+{
+	return m->cplane + foot*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * cpl1(struct mem_t *m, index_t foot)
+{
+	return m->cplane + foot*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE index_t * cbdy(struct mem_t *m, index_t foot)
+{
+	return m->cbody + foot;
+}
+
+TP_FUNC_INLINE index_t _cbdy(struct mem_t *m, index_t foot)
+{
+	return *(m->cbody + foot);
+}
+#endif
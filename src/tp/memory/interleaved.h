@@ -0,0 +1,571 @@
+/*
+ * interleaved.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#ifdef TP_COMPACT_JACOBIAN
+#error TP_COMPACT_JACOBIAN defined, but not implemented for the interleaved mem. layout
+#endif
+
+// Number of worlds interleaved in a block, by default one cache line per scalar
+#ifndef TP_LANES
+#define TP_LANES (64/sizeof(real_t))
+#endif
+
+/* The memory layout. Every scalar of the simple.h layout is stored for
+ * TP_LANES worlds next to each other, e.g. q[(b*7+k)*TP_LANES + lane]. The
+ * components of vectors, quaternions and matrices are therefore TP_LANES
+ * elements apart, which the x(), y(), ij(), ... accessors account for.
+ */
+struct mem_block_t
+{
+	real_t q[(TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4)*TP_LANES];		// Generalized position variable, pos + quatern
+	real_t v[(TP_BODIES)*TP_SIZE_VEC6*TP_LANES];						// Generalized velocity variable, vel + omega
+	real_t mi[(TP_BODIES)*TP_LANES];									// Inverse mass
+	real_t Ibi[(TP_BODIES)*3*TP_SIZE_VEC3*TP_LANES];					// Inverse inertia matrix
+	real_t R[(TP_BODIES)*3*TP_SIZE_VEC3*TP_LANES]; 					// Convenience matrix
+	real_t Iwi[(TP_BODIES)*3*TP_SIZE_VEC3*TP_LANES];					// Inverse inertia matrix, world frame
+
+	real_t Fe[(TP_BODIES)*TP_SIZE_VEC6*TP_LANES];					// External force
+
+	real_t J[2*TP_SIZE_VEC6*TP_CONSTRAINTS*TP_LANES];				// Constraint Jacobian
+
+	real_t lambda[TP_CONSTRAINTS*TP_LANES];							// F_c = J^{T}\lambda
+	real_t lambda_min[TP_CONSTRAINTS*TP_LANES];						// min
+	real_t lambda_max[TP_CONSTRAINTS*TP_LANES];						// max
+
+	index_t mm[(TP_MOTORS)*TP_LANES];								// Mapping motors->hinges
+	index_t rorder[TP_HINGE_MOTOR_CONSTRAINTS*TP_LANES];			// Solver order of hinge and motor rows
+#ifdef TP_TREE_SOLVER
+	index_t tnodes[((TP_BODIES)+(TP_HINGES))*TP_LANES];			// Tree nodes with parents before children
+	index_t tparent[((TP_BODIES)+(TP_HINGES))*TP_LANES];			// Parent tree node, -1 for roots
+#endif
+	real_t mdspeed[(TP_MOTORS)*TP_LANES];							// Desired speed for motors
+	real_t relax[3*TP_LANES];										// Relaxation factors of hinge, motor and contact rows
+	real_t iniq[(TP_HINGES)*TP_SIZE_VEC4*TP_LANES];					// Quaternions for initial rotations
+
+	index_t Jm[2*TP_CONSTRAINTS*TP_LANES];							// Mapping->bodies, sparse Jacobian
+	index_t crows[TP_CONTACT_CONSTRAINTS*(TP_FEET)*TP_LANES];		// Active contact rows
+	index_t ncrows[TP_LANES];										// Number of active contact rows
+	real_t B[2*TP_SIZE_VEC6*TP_CONSTRAINTS*TP_LANES];				// M^{-1}J^{T}, for solving
+	real_t a[(TP_BODIES)*TP_SIZE_VEC6*TP_LANES];						// B\lambda, for solving
+	real_t d[TP_CONSTRAINTS*TP_LANES];								// diag(JB), for solving
+	real_t di[TP_CONSTRAINTS*TP_LANES];								// 1/diag(JB), for solving
+	real_t rhs[TP_CONSTRAINTS*TP_LANES];								// Right hand side, for solving
+#ifdef TP_BLOCK_HINGES
+	real_t Hi[(TP_HINGES)*25*TP_LANES];								// (JB)^{-1} of hinge row blocks, for solving
+#endif
+
+	real_t haxes[(TP_HINGES)*2*TP_SIZE_VEC6*TP_LANES];				// Hinge axis 1+2, tangent base 1
+	real_t hanchors[(TP_HINGES)*TP_SIZE_VEC6*TP_LANES];				// Hinge anchors ( -''- )
+	real_t haxes_w[(TP_HINGES)*TP_SIZE_VEC6*TP_LANES];				// Hinge axis 1+2, world frame
+	real_t hanchors_w[(TP_HINGES)*TP_SIZE_VEC6*TP_LANES];			// Hinge anchors, world frame
+
+#ifdef TP_DEBUG
+	real_t Fc[(TP_BODIES)*TP_SIZE_VEC6*TP_LANES];					// Constraint force
+	real_t cinfo[3*(TP_FEET)*TP_SIZE_VEC6*TP_LANES];					// Contact points + contact normals
+	real_t cplane[(TP_FEET)*TP_SIZE_VEC6*TP_LANES];					// Contact plane (axes where slip is eliminated)
+	index_t cbody[(TP_FEET)*TP_LANES];								// Body indexes connected to feet
+#endif
+};
+
+// Handle to one world (lane) in a block
+struct mem_t
+{
+	struct mem_block_t *block;
+	int lane;
+};
+
+TP_FUNC_INLINE
+void zero_lane(real_t *storage, size_t size, int lane, real_t value)
+{
+	for(size_t i = 0; i < size; ++i) storage[i*TP_LANES + lane] = value;
+}
+
+TP_FUNC_INLINE
+void zero_lane(index_t *storage, size_t size, int lane, index_t value)
+{
+	for(size_t i = 0; i < size; ++i) storage[i*TP_LANES + lane] = value;
+}
+
+TP_FUNC_INLINE
+void zero_memory(struct mem_t *mem)
+{
+	struct mem_block_t *blk = mem->block;
+	int l = mem->lane;
+
+	zero_lane(blk->q, (TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4), l, TP_REAL(0.0));
+	zero_lane(blk->v, (TP_BODIES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->mi, (TP_BODIES), l, TP_REAL(0.0));
+	zero_lane(blk->Ibi, (TP_BODIES)*3*TP_SIZE_VEC3, l, TP_REAL(0.0));
+	zero_lane(blk->R, (TP_BODIES)*3*TP_SIZE_VEC3, l, TP_REAL(0.0));
+	zero_lane(blk->Iwi, (TP_BODIES)*3*TP_SIZE_VEC3, l, TP_REAL(0.0));
+	zero_lane(blk->Fe, (TP_BODIES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->J, 2*TP_SIZE_VEC6*TP_CONSTRAINTS, l, TP_REAL(0.0));
+
+	zero_lane(blk->lambda, TP_CONSTRAINTS, l, TP_REAL(0.0));
+	zero_lane(blk->lambda_min, TP_CONSTRAINTS, l, TP_REAL(-1048576.0));
+	zero_lane(blk->lambda_max, TP_CONSTRAINTS, l, TP_REAL(1048576.0));
+
+	zero_lane(blk->Jm, 2*TP_CONSTRAINTS, l, (index_t)0);
+	zero_lane(blk->crows, TP_CONTACT_CONSTRAINTS*(TP_FEET), l, (index_t)0);
+	zero_lane(blk->ncrows, 1, l, (index_t)0);
+	zero_lane(blk->B, 2*TP_SIZE_VEC6*TP_CONSTRAINTS, l, TP_REAL(0.0));
+	zero_lane(blk->a, (TP_BODIES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->d, TP_CONSTRAINTS, l, TP_REAL(0.0));
+	zero_lane(blk->di, TP_CONSTRAINTS, l, TP_REAL(0.0));
+	zero_lane(blk->rhs, TP_CONSTRAINTS, l, TP_REAL(0.0));
+#ifdef TP_BLOCK_HINGES
+	zero_lane(blk->Hi, (TP_HINGES)*25, l, TP_REAL(0.0));
+#endif
+	zero_lane(blk->hanchors, (TP_HINGES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->hanchors_w, (TP_HINGES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->haxes_w, (TP_HINGES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->haxes, (TP_HINGES)*2*TP_SIZE_VEC6, l, TP_REAL(0.0));
+
+	zero_lane(blk->mm, (TP_MOTORS), l, (index_t)0);
+	for(size_t i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) blk->rorder[i*TP_LANES + l] = i;
+#ifdef TP_TREE_SOLVER
+	for(size_t i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) blk->tnodes[i*TP_LANES + l] = i;
+	zero_lane(blk->tparent, (TP_BODIES)+(TP_HINGES), l, (index_t)-1);
+#endif
+	zero_lane(blk->mdspeed, (TP_MOTORS), l, TP_REAL(0.0));
+	zero_lane(blk->relax, 3, l, TP_REAL(1.0));
+	zero_lane(blk->iniq, (TP_HINGES)*TP_SIZE_VEC4, l, TP_REAL(0.0));
+
+#ifdef TP_DEBUG
+	zero_lane(blk->Fc, (TP_BODIES)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->cinfo, 3*(TP_FEET)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->cplane, (TP_FEET)*TP_SIZE_VEC6, l, TP_REAL(0.0));
+	zero_lane(blk->cbody, (TP_FEET), l, (index_t)0);
+#endif
+}
+
+/* Sets up the TP_LANES handles of a block and zero initializes all of its
+ * worlds. For the scalars of a block to share cache lines as intended, the
+ * block should be allocated 64 byte aligned.
+ */
+TP_FUNC_INLINE
+void init_mem_block(struct mem_block_t *block, struct mem_t *lanes)
+{
+	for(int l = 0; l < (int)(TP_LANES); ++l)
+	{
+		lanes[l].block = block;
+		lanes[l].lane = l;
+		zero_memory(lanes + l);
+	}
+}
+
+TP_FUNC_INLINE real_t * x(real_t *vec3)
+{
+	return vec3;
+}
+
+TP_FUNC_INLINE real_t _x(const real_t *vec3)
+{
+	return vec3[0];
+}
+
+TP_FUNC_INLINE real_t * y(real_t *vec3)
+{
+	return vec3+TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _y(const real_t *vec3)
+{
+	return vec3[TP_LANES];
+}
+
+TP_FUNC_INLINE real_t * z(real_t *vec3)
+{
+	return vec3+2*TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _z(const real_t *vec3)
+{
+	return vec3[2*TP_LANES];
+}
+
+TP_FUNC_INLINE real_t * q0(real_t *quatern)
+{
+	return quatern;
+}
+
+TP_FUNC_INLINE real_t _q0(const real_t *quatern)
+{
+	return quatern[0];
+}
+
+TP_FUNC_INLINE real_t * q1(real_t *quatern)
+{
+	return quatern+TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _q1(const real_t *quatern)
+{
+	return quatern[TP_LANES];
+}
+
+TP_FUNC_INLINE real_t * q2(real_t *quatern)
+{
+	return quatern+2*TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _q2(const real_t *quatern)
+{
+	return quatern[2*TP_LANES];
+}
+
+TP_FUNC_INLINE real_t * q3(real_t *quatern)
+{
+	return quatern+3*TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _q3(const real_t *quatern)
+{
+	return quatern[3*TP_LANES];
+}
+
+TP_FUNC_INLINE real_t * ij(real_t *mtx33, index_t row, index_t col)
+{
+	return mtx33 + (row*TP_SIZE_VEC3 + col)*TP_LANES;
+}
+
+TP_FUNC_INLINE real_t _ij(const real_t *mtx33, index_t row, index_t col)
+{
+	return *(mtx33 + (row*TP_SIZE_VEC3 + col)*TP_LANES);
+}
+
+TP_FUNC_INLINE real_t * haxis(struct mem_t *m, index_t hinge_num)
+{
+	return m->block->haxes + (hinge_num*2*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * haxis_num(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->block->haxes + (hinge_num*2*TP_SIZE_VEC6 + 3*body_index)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * ht0(struct mem_t *m, index_t hinge_num)
+{
+	return m->block->haxes + (hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * ht1(struct mem_t *m, index_t hinge_num)
+{
+	return m->block->haxes + (hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * hanchor(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->block->hanchors + (hinge_num*TP_SIZE_VEC6 + 3*body_index)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * haxis_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->block->haxes_w + (hinge_num*TP_SIZE_VEC6 + 3*body_index)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * hanchor_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->block->hanchors_w + (hinge_num*TP_SIZE_VEC6 + 3*body_index)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * pos(struct mem_t *m, index_t body)
+{
+	return m->block->q + (body*(TP_SIZE_VEC3+TP_SIZE_VEC4))*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * vel(struct mem_t *m, index_t body)
+{
+	return m->block->v + (body*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * omega(struct mem_t *m, index_t body)
+{
+	return m->block->v + (body*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * quatern(struct mem_t *m, index_t body)
+{
+	return m->block->q + (body*(TP_SIZE_VEC3+TP_SIZE_VEC4) + TP_SIZE_VEC3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * mi(struct mem_t *m, index_t body)
+{
+	return m->block->mi + body*TP_LANES + m->lane;
+}
+TP_FUNC_INLINE real_t _mi(struct mem_t *m, index_t body)
+{
+	return *(m->block->mi + body*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * R(struct mem_t *m, index_t body)
+{
+	return m->block->R + (body*3*TP_SIZE_VEC3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * Ibi(struct mem_t *m, index_t body)
+{
+	return m->block->Ibi + (body*3*TP_SIZE_VEC3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * Iwi(struct mem_t *m, index_t body)
+{
+	return m->block->Iwi + (body*3*TP_SIZE_VEC3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * tFe(struct mem_t *m, index_t body)
+{
+	return m->block->Fe + (body*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * aFe(struct mem_t *m, index_t body)
+{
+	return m->block->Fe + (body*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t * Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->block->Jm + (constraint*2 + body)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return *(m->block->Jm + (constraint*2 + body)*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE index_t * crow(struct mem_t *m, index_t num)
+{
+	return m->block->crows + num*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _crow(struct mem_t *m, index_t num)
+{
+	return *(m->block->crows + num*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE index_t * ncrows(struct mem_t *m)
+{
+	return m->block->ncrows + m->lane;
+}
+
+TP_FUNC_INLINE index_t _ncrows(struct mem_t *m)
+{
+	return *(m->block->ncrows + m->lane);
+}
+
+TP_FUNC_INLINE real_t * tJ(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->block->J + ((constraint*2 + body)*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * aJ(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->block->J + ((constraint*2 + body)*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * tB(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->block->B + ((constraint*2 + body)*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * aB(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->block->B + ((constraint*2 + body)*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * ta(struct mem_t *m, index_t body)
+{
+	return m->block->a + (body*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * aa(struct mem_t *m, index_t body)
+{
+	return m->block->a + (body*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * lambda(struct mem_t *m, index_t constraint)
+{
+	return m->block->lambda + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _lambda(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->lambda + constraint*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * lambda_min(struct mem_t *m, index_t constraint)
+{
+	return m->block->lambda_min + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _lambda_min(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->lambda_min + constraint*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * lambda_max(struct mem_t *m, index_t constraint)
+{
+	return m->block->lambda_max + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _lambda_max(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->lambda_max + constraint*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * d(struct mem_t *m, index_t constraint)
+{
+	return m->block->d + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _d(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->d + constraint*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * di(struct mem_t *m, index_t constraint)
+{
+	return m->block->di + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _di(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->di + constraint*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * rhs(struct mem_t *m, index_t constraint)
+{
+	return m->block->rhs + constraint*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _rhs(struct mem_t *m, index_t constraint)
+{
+	return *(m->block->rhs + constraint*TP_LANES + m->lane);
+}
+
+#ifdef TP_BLOCK_HINGES
+TP_FUNC_INLINE real_t * Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return m->block->Hi + (hinge*25 + row*5 + col)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return *(m->block->Hi + (hinge*25 + row*5 + col)*TP_LANES + m->lane);
+}
+#endif
+
+TP_FUNC_INLINE real_t * mds(struct mem_t *m, index_t motor)
+{
+	return m->block->mdspeed + motor*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _mds(struct mem_t *m, index_t motor)
+{
+	return *(m->block->mdspeed + motor*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE real_t * relax(struct mem_t *m, index_t type)
+{
+	return m->block->relax + type*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t _relax(struct mem_t *m, index_t type)
+{
+	return *(m->block->relax + type*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE index_t * mm(struct mem_t *m, index_t motor)
+{
+	return m->block->mm + motor*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _mm(struct mem_t *m, index_t motor)
+{
+	return *(m->block->mm + motor*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE index_t * rorder(struct mem_t *m, index_t row)
+{
+	return m->block->rorder + row*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _rorder(struct mem_t *m, index_t row)
+{
+	return *(m->block->rorder + row*TP_LANES + m->lane);
+}
+
+#ifdef TP_TREE_SOLVER
+TP_FUNC_INLINE index_t * tnode(struct mem_t *m, index_t num)
+{
+	return m->block->tnodes + num*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _tnode(struct mem_t *m, index_t num)
+{
+	return *(m->block->tnodes + num*TP_LANES + m->lane);
+}
+
+TP_FUNC_INLINE index_t * tparent(struct mem_t *m, index_t node)
+{
+	return m->block->tparent + node*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _tparent(struct mem_t *m, index_t node)
+{
+	return *(m->block->tparent + node*TP_LANES + m->lane);
+}
+#endif
+
+TP_FUNC_INLINE real_t * iniquatern(struct mem_t *m, index_t hinge_num)
+{
+	return m->block->iniq + (hinge_num*TP_SIZE_VEC4)*TP_LANES + m->lane;
+}
+
+#ifdef TP_DEBUG
+TP_FUNC_INLINE real_t * tFc(struct mem_t *m, index_t body)
+{
+	return m->block->Fc + (body*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * aFc(struct mem_t *m, index_t body)
+{
+	return m->block->Fc + (body*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * cpo(struct mem_t *m, index_t contact)
+{
+	return m->block->cinfo + (contact*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * cno(struct mem_t *m, index_t contact)
+{
+	return m->block->cinfo + (contact*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * cpl0(struct mem_t *m, index_t foot)
+{
+	return m->block->cplane + (foot*TP_SIZE_VEC6)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE real_t * cpl1(struct mem_t *m, index_t foot)
+{
+	return m->block->cplane + (foot*TP_SIZE_VEC6 + 3)*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t * cbdy(struct mem_t *m, index_t foot)
+{
+	return m->block->cbody + foot*TP_LANES + m->lane;
+}
+
+TP_FUNC_INLINE index_t _cbdy(struct mem_t *m, index_t foot)
+{
+	return *(m->block->cbody + foot*TP_LANES + m->lane);
+}
+#endif
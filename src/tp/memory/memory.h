@@ -9,7 +9,10 @@
  *
  * @ingroup tp-mem
  */
+// With TP_DYNAMIC the size macros read m, which must then be the world at hand
+#if !defined(TP_WORLD) && !defined(TP_DYNAMIC)
 struct mem_t *m;
+#endif
 
 /**
  * @name Memory Access Functions
@@ -173,6 +176,10 @@ void set_mtx33(const tp_mtx33 new_mtx, real_t *storage)
 }
 //@}
 
+// The declarations below are for documentation only, and would redeclare the
+// member functions of tp::World
+#ifndef TP_WORLD
+
 /**
  * @name Memory Access Implementation Unique Functions
  *
@@ -405,6 +412,31 @@ TP_FUNC_INLINE real_t * ht1(struct mem_t *m, index_t hinge_num);
  */
 TP_FUNC_INLINE real_t * hanchor(struct mem_t *m, index_t hinge_num, index_t body_index);
 
+/**
+ * Returns memory pointer to a hinge axis in world coordinates, as seen from either
+ * body. The world frame axes are part of the kinematics cache, see update_kinematics().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			hinge_num	Number of hinge whose axis pointer is to be returned.
+ * @param			body_index	0 or 1, whether to return axis of first or second body.
+ * @returns Vector pointer for hinge axis in world coordinates.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * haxis_world(struct mem_t *m, index_t hinge_num, index_t body_index);
+
+/**
+ * Returns memory pointer to a hinge anchor rotated to world coordinates, i.e. the
+ * vector from the center of gravity of the body to the anchor point. The world frame
+ * anchors are part of the kinematics cache, see update_kinematics().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			hinge_num	Number of hinge whose anchor is to be returned.
+ * @param			body_index	0 or 1, whether to return anchor of first or second body.
+ * @returns Vector pointer for hinge anchor in world coordinates.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * hanchor_world(struct mem_t *m, index_t hinge_num, index_t body_index);
+
 /**
  * Returns memory pointer to position vector of body.
  *
@@ -486,6 +518,18 @@ TP_FUNC_INLINE real_t * R(struct mem_t *m, index_t body);
  */
 TP_FUNC_INLINE real_t * Ibi(struct mem_t *m, index_t body);
 
+/**
+ * Returns a memory pointer to the inverse inertia tensor of a body, given in world
+ * coordinates, \f$R I_b^{-1} R^{T}\f$. The tensor is part of the kinematics cache,
+ * see update_kinematics().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			body		Body to query, in interval [0, TP_BODIES-1].
+ * @returns Pointer to the world inverse inertia tensor of a body.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * Iwi(struct mem_t *m, index_t body);
+
 /**
  * Returns a memory pointer to the translation external force acting on a body.
  *
@@ -531,9 +575,54 @@ TP_FUNC_INLINE index_t * Jm(struct mem_t *m, index_t constraint, index_t body_in
  */
 TP_FUNC_INLINE index_t _Jm(struct mem_t *m, index_t constraint, index_t body_index);
 
+/**
+ * Returns a memory pointer to an entry of the list of active contact rows. The
+ * contact rows of the Jacobian that have been filled in by the collision detection
+ * during a step are listed here, see activate_contact_row(). Only the hinge and motor
+ * rows and the listed contact rows are processed by the constraint solver.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			num			Entry to query, in interval [0, _ncrows(m)-1].
+ * @returns Pointer to the constraint index of an active contact row.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t * crow(struct mem_t *m, index_t num);
+
+/**
+ * Returns an entry of the list of active contact rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			num			Entry to query, in interval [0, _ncrows(m)-1].
+ * @returns Constraint index of an active contact row.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t _crow(struct mem_t *m, index_t num);
+
+/**
+ * Returns a memory pointer to the number of active contact rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @returns Pointer to the number of active contact rows.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t * ncrows(struct mem_t *m);
+
+/**
+ * Returns the number of active contact rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @returns Number of active contact rows.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t _ncrows(struct mem_t *m);
+
 /**
  * Returns a memory pointer to the translational part of a Jacobian row.
  *
+ * If #TP_COMPACT_JACOBIAN is defined, only the translational parts of the contact
+ * rows are stored, see get_row_tJ(), and the hinge and motor rows must not be
+ * queried.
+ *
  * @param			m			Pointer to the memory representing the simulation world.
  * @param			constraint	Constraint to query, in interval [0, #TP_CONSTRAINTS-1].
  * @param 			body_index	0 or 1, first or second body.
@@ -557,6 +646,10 @@ TP_FUNC_INLINE real_t * aJ(struct mem_t *m, index_t constraint, index_t body_ind
  * Returns a memory pointer to the translational part of the \f$B\f$ variable.
  * \see compute_B.
  *
+ * If #TP_COMPACT_JACOBIAN is defined, only the translational parts of the contact
+ * rows are stored, see get_row_tB(), and the hinge and motor rows must not be
+ * queried.
+ *
  * @param			m			Pointer to the memory representing the simulation world.
  * @param			constraint	Constraint to query, in interval [0, #TP_CONSTRAINTS-1].
  * @param 			body_index	0 or 1, first or second body.
@@ -685,6 +778,28 @@ TP_FUNC_INLINE real_t * d(struct mem_t *m, index_t constraint);
  */
 TP_FUNC_INLINE real_t _d(struct mem_t *m, index_t constraint);
 
+/**
+ * Returns a memory pointer to the entry in the inverse of the \f$d\f$ variable
+ * connected to a constraint, zero if \f$d\f$ is too small to invert. \see setup_rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			constraint	Constraint to query, in interval [0, #TP_CONSTRAINTS-1].
+ * @returns Pointer to constraint entry in the inverse of the \f$d\f$ variable.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * di(struct mem_t *m, index_t constraint);
+
+/**
+ * Returns the entry in the inverse of the \f$d\f$ variable connected to a
+ * constraint. \see setup_rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			constraint	Constraint to query, in interval [0, #TP_CONSTRAINTS-1].
+ * @returns Constraint entry in the inverse of the \f$d\f$ variable.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t _di(struct mem_t *m, index_t constraint);
+
 /**
  * Returns a memory pointer to right hand side vector entry for a constraint.
  *
@@ -705,6 +820,34 @@ TP_FUNC_INLINE real_t * rhs(struct mem_t *m, index_t constraint);
  */
 TP_FUNC_INLINE real_t _rhs(struct mem_t *m, index_t constraint);
 
+#ifdef TP_BLOCK_HINGES
+/**
+ * Returns a memory pointer to an entry of the inverted block \f$(JB)^{-1}\f$ of the
+ * five rows of a hinge, only available if #TP_BLOCK_HINGES is defined.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			hinge		Hinge to query, in interval [0, #TP_HINGES-1].
+ * @param			row			Row of the entry, in interval [0, 4].
+ * @param			col			Column of the entry, in interval [0, 4].
+ * @returns Pointer to the entry.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * Hi(struct mem_t *m, index_t hinge, index_t row, index_t col);
+
+/**
+ * Returns an entry of the inverted block \f$(JB)^{-1}\f$ of the five rows of a
+ * hinge, only available if #TP_BLOCK_HINGES is defined.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			hinge		Hinge to query, in interval [0, #TP_HINGES-1].
+ * @param			row			Row of the entry, in interval [0, 4].
+ * @param			col			Column of the entry, in interval [0, 4].
+ * @returns The entry.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t _Hi(struct mem_t *m, index_t hinge, index_t row, index_t col);
+#endif
+
 /**
  * Returns a memory pointer to desired angular velocity of a motor.
  *
@@ -725,6 +868,27 @@ TP_FUNC_INLINE real_t * mds(struct mem_t *m, index_t motor);
  */
 TP_FUNC_INLINE real_t _mds(struct mem_t *m, index_t motor);
 
+/**
+ * Returns a memory pointer to the relaxation factor \f$\omega\f$ of a type of
+ * constraint rows, see solve_row(). The factors are one after zero_memory().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			type		Type of rows, #TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT.
+ * @returns Pointer to the relaxation factor.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t * relax(struct mem_t *m, index_t type);
+
+/**
+ * Returns the relaxation factor \f$\omega\f$ of a type of constraint rows.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			type		Type of rows, #TP_RELAX_HINGE, #TP_RELAX_MOTOR or #TP_RELAX_CONTACT.
+ * @returns The relaxation factor.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE real_t _relax(struct mem_t *m, index_t type);
+
 /**
  * Returns a memory pointer to the motor map entry connecting a motor to a hinge.
  *
@@ -745,6 +909,74 @@ TP_FUNC_INLINE index_t * mm(struct mem_t *m, index_t motor);
  */
 TP_FUNC_INLINE index_t _mm(struct mem_t *m, index_t motor);
 
+/**
+ * Returns a memory pointer to the row order entry of a position in the solver
+ * sweep. The hinge rows come before the motor rows, and the order is the identity
+ * after zero_memory(), see order_rows().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			row			Position to query, in interval [0, #TP_HINGE_MOTOR_CONSTRAINTS-1].
+ * @returns Pointer to the constraint index solved at the position.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t * rorder(struct mem_t *m, index_t row);
+
+/**
+ * Returns the constraint index solved at a position in the solver sweep.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			row			Position to query, in interval [0, #TP_HINGE_MOTOR_CONSTRAINTS-1].
+ * @returns The constraint index solved at the position.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t _rorder(struct mem_t *m, index_t row);
+
+#ifdef TP_TREE_SOLVER
+/**
+ * Returns a memory pointer to an entry of the order of the tree nodes, the bodies
+ * and hinges with parents before children, only available if #TP_TREE_SOLVER is
+ * defined. The order is kept up to date by create_hinge(), see order_tree().
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			num			Position to query, in interval [0, #TP_BODIES+#TP_HINGES-1].
+ * @returns Pointer to the tree node at the position.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t * tnode(struct mem_t *m, index_t num);
+
+/**
+ * Returns the tree node at a position in the order of the tree nodes, only
+ * available if #TP_TREE_SOLVER is defined.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			num			Position to query, in interval [0, #TP_BODIES+#TP_HINGES-1].
+ * @returns The tree node at the position, -1 at position 0 if the hinges form a loop.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t _tnode(struct mem_t *m, index_t num);
+
+/**
+ * Returns a memory pointer to the parent of a tree node, only available if
+ * #TP_TREE_SOLVER is defined.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			node		Node to query, in interval [0, #TP_BODIES+#TP_HINGES-1].
+ * @returns Pointer to the parent node.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t * tparent(struct mem_t *m, index_t node);
+
+/**
+ * Returns the parent of a tree node, only available if #TP_TREE_SOLVER is defined.
+ *
+ * @param			m			Pointer to the memory representing the simulation world.
+ * @param			node		Node to query, in interval [0, #TP_BODIES+#TP_HINGES-1].
+ * @returns The parent node, -1 for roots.
+ * @ingroup tp-mem
+ */
+TP_FUNC_INLINE index_t _tparent(struct mem_t *m, index_t node);
+#endif
+
 /**
  * Returns a memory pointer to the initial rotation quaternion for a hinge.
  *
@@ -847,3 +1079,4 @@ TP_FUNC_INLINE index_t * cbdy(struct mem_t *m, index_t foot);
 TP_FUNC_INLINE index_t _cbdy(struct mem_t *m, index_t foot);
 #endif
 //@}
+#endif
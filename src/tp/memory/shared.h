@@ -0,0 +1,601 @@
+/*
+ * shared.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+/* The model data, which is the same for all worlds of a robot. It is written
+ * while the model is configured and only read while stepping, so a single copy
+ * is shared by all worlds.
+ */
+struct model_t
+{
+	real_t mi[(TP_BODIES)];												// Inverse mass
+	real_t Ibi[(TP_BODIES)*3*TP_SIZE_VEC3];								// Inverse inertia matrix
+
+	real_t lambda_min[TP_HINGE_MOTOR_CONSTRAINTS];						// min, hinge and motor rows
+	real_t lambda_max[TP_HINGE_MOTOR_CONSTRAINTS];						// max, hinge and motor rows
+
+	index_t mm[(TP_MOTORS)];											// Mapping motors->hinges
+	index_t rorder[TP_HINGE_MOTOR_CONSTRAINTS];							// Solver order of hinge and motor rows
+	real_t iniq[(TP_HINGES)*TP_SIZE_VEC4];								// Quaternions for initial rotations
+
+	real_t haxes[(TP_HINGES)*2*TP_SIZE_VEC6];							// Hinge axis 1+2, tangent base 1
+	real_t hanchors[(TP_HINGES)*TP_SIZE_VEC6];							// Hinge anchors ( -''- )
+};
+
+/* Intermediate results of the solver. They are recomputed at the start of
+ * every step, so one copy per thread serves all worlds stepped by the thread.
+ */
+struct work_t
+{
+	real_t B[TP_JACOBIAN_SIZE];										// M^{-1}J^{T}, for solving
+	real_t a[(TP_BODIES)*TP_SIZE_VEC6];									// B\lambda, for solving
+	real_t d[TP_CONSTRAINTS];											// diag(JB), for solving
+	real_t di[TP_CONSTRAINTS];											// 1/diag(JB), for solving
+	real_t rhs[TP_CONSTRAINTS];											// Right hand side, for solving
+#ifdef TP_BLOCK_HINGES
+	real_t Hi[(TP_HINGES)*25];											// (JB)^{-1} of hinge row blocks, for solving
+#endif
+};
+
+// The memory layout, the state of one world
+struct mem_t
+{
+	struct model_t *model;												// Shared model data
+
+	real_t q[(TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4)];					// Generalized position variable, pos + quatern
+	real_t v[(TP_BODIES)*TP_SIZE_VEC6];									// Generalized velocity variable, vel + omega
+	real_t R[(TP_BODIES)*3*TP_SIZE_VEC3]; 								// Convenience matrix
+	real_t Iwi[(TP_BODIES)*3*TP_SIZE_VEC3];								// Inverse inertia matrix, world frame
+	real_t haxes_w[(TP_HINGES)*TP_SIZE_VEC6];							// Hinge axis 1+2, world frame
+	real_t hanchors_w[(TP_HINGES)*TP_SIZE_VEC6];						// Hinge anchors, world frame
+
+	real_t Fe[(TP_BODIES)*TP_SIZE_VEC6];								// External force
+
+	real_t J[TP_JACOBIAN_SIZE];										// Constraint Jacobian
+
+	real_t lambda[TP_CONSTRAINTS];										// F_c = J^{T}\lambda
+	real_t lambda_min[TP_CONTACT_CONSTRAINTS*(TP_FEET)];				// min, contact rows
+	real_t lambda_max[TP_CONTACT_CONSTRAINTS*(TP_FEET)];				// max, contact rows
+
+	real_t mdspeed[(TP_MOTORS)];										// Desired speed for motors
+	real_t relax[3];													// Relaxation factors of hinge, motor and contact rows
+
+	index_t Jm[2*TP_CONSTRAINTS];										// Mapping->bodies, sparse Jacobian
+	index_t crows[TP_CONTACT_CONSTRAINTS*(TP_FEET)];					// Active contact rows
+	index_t ncrows;														// Number of active contact rows
+#ifdef TP_TREE_SOLVER
+	index_t tnodes[(TP_BODIES)+(TP_HINGES)];							// Tree nodes with parents before children
+	index_t tparent[(TP_BODIES)+(TP_HINGES)];							// Parent tree node, -1 for roots
+#endif
+
+#ifdef TP_DEBUG
+	real_t Fc[(TP_BODIES)*TP_SIZE_VEC6];								// Constraint force
+	real_t cinfo[3*(TP_FEET)*TP_SIZE_VEC6];								// Contact points + contact normals
+	real_t cplane[(TP_FEET)*TP_SIZE_VEC6];								// Contact plane (axes where slip is eliminated)
+	index_t cbody[(TP_FEET)];											// Body indexes connected to feet
+#endif
+};
+
+/* Zeroes the model data. Call once for a model, before configuring the first
+ * world that uses it.
+ */
+TP_FUNC_INLINE
+void zero_model(struct model_t *model)
+{
+	for(size_t i = 0; i < (TP_BODIES); ++i) model->mi[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) model->Ibi[i] = TP_REAL(0.0);
+
+	for(size_t i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) model->lambda_min[i] = TP_REAL(-1048576.0);
+	for(size_t i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) model->lambda_max[i] = TP_REAL(1048576.0);
+
+	for(size_t i = 0; i < (TP_MOTORS); ++i) model->mm[i] = 0;
+	for(size_t i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) model->rorder[i] = i;
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC4; ++i) model->iniq[i] = TP_REAL(0.0);
+
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) model->hanchors[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_HINGES)*2*TP_SIZE_VEC6; ++i) model->haxes[i] = TP_REAL(0.0);
+}
+
+/* Zeroes the state of a world, the model it points to is left untouched.
+ * A configured world can be duplicated by copying the struct, the copy shares
+ * the model of the original.
+ */
+TP_FUNC_INLINE
+void zero_memory(struct mem_t *mem)
+{
+	for(size_t i = 0; i < (TP_BODIES)*(TP_SIZE_VEC3+TP_SIZE_VEC4); ++i) mem->q[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) mem->v[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) mem->R[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) mem->Iwi[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) mem->haxes_w[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) mem->hanchors_w[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) mem->Fe[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < TP_JACOBIAN_SIZE; ++i) mem->J[i] = TP_REAL(0.0);
+
+	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->lambda[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < TP_CONTACT_CONSTRAINTS*(TP_FEET); ++i) mem->lambda_min[i] = TP_REAL(-1048576.0);
+	for(size_t i = 0; i < TP_CONTACT_CONSTRAINTS*(TP_FEET); ++i) mem->lambda_max[i] = TP_REAL(1048576.0);
+
+	for(size_t i = 0; i < (TP_MOTORS); ++i) mem->mdspeed[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < 3; ++i) mem->relax[i] = TP_REAL(1.0);
+	for(size_t i = 0; i < 2*TP_CONSTRAINTS; ++i) mem->Jm[i] = 0;
+	for(size_t i = 0; i < TP_CONTACT_CONSTRAINTS*(TP_FEET); ++i) mem->crows[i] = 0;
+	mem->ncrows = 0;
+#ifdef TP_TREE_SOLVER
+	for(size_t i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) mem->tnodes[i] = i;
+	for(size_t i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) mem->tparent[i] = -1;
+#endif
+
+#ifdef TP_DEBUG
+	for(size_t i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) mem->Fc[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < 3*(TP_FEET)*TP_SIZE_VEC6; ++i) mem->cinfo[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_FEET)*TP_SIZE_VEC6; ++i) mem->cplane[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_FEET); ++i) mem->cbody[i] = 0;
+#endif
+}
+
+// Solver work memory is per thread, see use_work()
+#define TP_THREAD_WORK
+
+// The solver work memory used by the calling thread, its own unless replaced by use_work()
+TP_FUNC_INLINE struct work_t ** work_slot()
+{
+	static thread_local struct work_t w;
+	static thread_local struct work_t *current = &w;
+	return &current;
+}
+
+TP_FUNC_INLINE struct work_t * work()
+{
+	return *work_slot();
+}
+
+/* Makes the calling thread solve on the work memory of another thread, for
+ * solving one world on several threads, see solve_for_lambda_parallel().
+ * Returns the work memory used before, for restoring it afterwards.
+ */
+TP_FUNC_INLINE struct work_t * use_work(struct work_t *w)
+{
+	struct work_t *previous = *work_slot();
+	*work_slot() = w;
+	return previous;
+}
+
+TP_FUNC_INLINE real_t * x(real_t *vec3)
+{
+	return vec3;
+}
+
+TP_FUNC_INLINE real_t _x(const real_t *vec3)
+{
+	return vec3[0];
+}
+
+TP_FUNC_INLINE real_t * y(real_t *vec3)
+{
+	return vec3+1;
+}
+
+TP_FUNC_INLINE real_t _y(const real_t *vec3)
+{
+	return vec3[1];
+}
+
+TP_FUNC_INLINE real_t * z(real_t *vec3)
+{
+	return vec3+2;
+}
+
+TP_FUNC_INLINE real_t _z(const real_t *vec3)
+{
+	return vec3[2];
+}
+
+TP_FUNC_INLINE real_t * q0(real_t *quatern)
+{
+	return quatern;
+}
+
+TP_FUNC_INLINE real_t _q0(const real_t *quatern)
+{
+	return quatern[0];
+}
+
+TP_FUNC_INLINE real_t * q1(real_t *quatern)
+{
+	return quatern+1;
+}
+
+TP_FUNC_INLINE real_t _q1(const real_t *quatern)
+{
+	return quatern[1];
+}
+
+TP_FUNC_INLINE real_t * q2(real_t *quatern)
+{
+	return quatern+2;
+}
+
+TP_FUNC_INLINE real_t _q2(const real_t *quatern)
+{
+	return quatern[2];
+}
+
+TP_FUNC_INLINE real_t * q3(real_t *quatern)
+{
+	return quatern+3;
+}
+
+TP_FUNC_INLINE real_t _q3(const real_t *quatern)
+{
+	return quatern[3];
+}
+
+TP_FUNC_INLINE real_t * ij(real_t *mtx33, index_t row, index_t col)
+{
+	return mtx33 + row*TP_SIZE_VEC3 + col;
+}
+
+TP_FUNC_INLINE real_t _ij(const real_t *mtx33, index_t row, index_t col)
+{
+	return *(mtx33 + row*TP_SIZE_VEC3 + col);
+}
+
+TP_FUNC_INLINE real_t * haxis(struct mem_t *m, index_t hinge_num)
+{
+	return m->model->haxes + hinge_num*2*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * haxis_num(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->model->haxes + hinge_num*2*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * ht0(struct mem_t *m, index_t hinge_num)
+{
+	return m->model->haxes + hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * ht1(struct mem_t *m, index_t hinge_num)
+{
+	return m->model->haxes + hinge_num*2*TP_SIZE_VEC6 + TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * hanchor(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->model->hanchors + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * haxis_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->haxes_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * hanchor_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->hanchors_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * pos(struct mem_t *m, index_t body)
+{
+	return m->q + body*(TP_SIZE_VEC3+TP_SIZE_VEC4);
+}
+
+TP_FUNC_INLINE real_t * vel(struct mem_t *m, index_t body)
+{
+	return m->v + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * omega(struct mem_t *m, index_t body)
+{
+	return m->v + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * quatern(struct mem_t *m, index_t body)
+{
+	return m->q + body*(TP_SIZE_VEC3+TP_SIZE_VEC4) + TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * mi(struct mem_t *m, index_t body)
+{
+	return m->model->mi + body;
+}
+TP_FUNC_INLINE real_t _mi(struct mem_t *m, index_t body)
+{
+	return *(m->model->mi + body);
+}
+
+TP_FUNC_INLINE real_t * R(struct mem_t *m, index_t body)
+{
+	return m->R + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * Ibi(struct mem_t *m, index_t body)
+{
+	return m->model->Ibi + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * Iwi(struct mem_t *m, index_t body)
+{
+	return m->Iwi + body*3*TP_SIZE_VEC3;
+}
+
+TP_FUNC_INLINE real_t * tFe(struct mem_t *m, index_t body)
+{
+	return m->Fe + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aFe(struct mem_t *m, index_t body)
+{
+	return m->Fe + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE index_t * Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return m->Jm + constraint*2 + body;
+}
+
+TP_FUNC_INLINE index_t _Jm(struct mem_t *m, index_t constraint, index_t body)
+{
+	return *(m->Jm + constraint*2 + body);
+}
+
+TP_FUNC_INLINE index_t * crow(struct mem_t *m, index_t num)
+{
+	return m->crows + num;
+}
+
+TP_FUNC_INLINE index_t _crow(struct mem_t *m, index_t num)
+{
+	return *(m->crows + num);
+}
+
+TP_FUNC_INLINE index_t * ncrows(struct mem_t *m)
+{
+	return &m->ncrows;
+}
+
+TP_FUNC_INLINE index_t _ncrows(struct mem_t *m)
+{
+	return m->ncrows;
+}
+
+TP_FUNC_INLINE real_t * tJ(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tJ()
+	return m->J + constraint*(TP_SIZE_VEC6);
+#else
+	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
+}
+
+TP_FUNC_INLINE real_t * aJ(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	return m->J + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
+	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6) + 3;
+#endif
+}
+
+TP_FUNC_INLINE real_t * tB(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tB()
+	return work()->B + constraint*(TP_SIZE_VEC6);
+#else
+	return work()->B + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
+}
+
+TP_FUNC_INLINE real_t * aB(struct mem_t *m, index_t constraint, index_t body)
+{
+#ifdef TP_COMPACT_JACOBIAN
+	return work()->B + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
+	return work()->B + (constraint*2 + body)*(TP_SIZE_VEC6)+3;
+#endif
+}
+
+TP_FUNC_INLINE real_t * ta(struct mem_t *m, index_t body)
+{
+	return work()->a + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aa(struct mem_t *m, index_t body)
+{
+	return work()->a + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * lambda(struct mem_t *m, index_t constraint)
+{
+	return m->lambda + constraint;
+}
+
+TP_FUNC_INLINE real_t _lambda(struct mem_t *m, index_t constraint)
+{
+	return *(m->lambda + constraint);
+}
+
+TP_FUNC_INLINE real_t * lambda_min(struct mem_t *m, index_t constraint)
+{
+	if(constraint < TP_HINGE_MOTOR_CONSTRAINTS)
+		return m->model->lambda_min + constraint;
+
+	return m->lambda_min + constraint - TP_HINGE_MOTOR_CONSTRAINTS;
+}
+
+TP_FUNC_INLINE real_t _lambda_min(struct mem_t *m, index_t constraint)
+{
+	return *lambda_min(m, constraint);
+}
+
+TP_FUNC_INLINE real_t * lambda_max(struct mem_t *m, index_t constraint)
+{
+	if(constraint < TP_HINGE_MOTOR_CONSTRAINTS)
+		return m->model->lambda_max + constraint;
+
+	return m->lambda_max + constraint - TP_HINGE_MOTOR_CONSTRAINTS;
+}
+
+TP_FUNC_INLINE real_t _lambda_max(struct mem_t *m, index_t constraint)
+{
+	return *lambda_max(m, constraint);
+}
+
+TP_FUNC_INLINE real_t * d(struct mem_t *m, index_t constraint)
+{
+	return work()->d + constraint;
+}
+
+TP_FUNC_INLINE real_t _d(struct mem_t *m, index_t constraint)
+{
+	return *(work()->d + constraint);
+}
+
+TP_FUNC_INLINE real_t * di(struct mem_t *m, index_t constraint)
+{
+	return work()->di + constraint;
+}
+
+TP_FUNC_INLINE real_t _di(struct mem_t *m, index_t constraint)
+{
+	return *(work()->di + constraint);
+}
+
+TP_FUNC_INLINE real_t * rhs(struct mem_t *m, index_t constraint)
+{
+	return work()->rhs + constraint;
+}
+
+TP_FUNC_INLINE real_t _rhs(struct mem_t *m, index_t constraint)
+{
+	return *(work()->rhs + constraint);
+}
+
+#ifdef TP_BLOCK_HINGES
+TP_FUNC_INLINE real_t * Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return work()->Hi + hinge*25 + row*5 + col;
+}
+
+TP_FUNC_INLINE real_t _Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return *(work()->Hi + hinge*25 + row*5 + col);
+}
+#endif
+
+TP_FUNC_INLINE real_t * mds(struct mem_t *m, index_t motor)
+{
+	return m->mdspeed + motor;
+}
+
+TP_FUNC_INLINE real_t _mds(struct mem_t *m, index_t motor)
+{
+	return *(m->mdspeed + motor);
+}
+
+TP_FUNC_INLINE real_t * relax(struct mem_t *m, index_t type)
+{
+	return m->relax + type;
+}
+
+TP_FUNC_INLINE real_t _relax(struct mem_t *m, index_t type)
+{
+	return *(m->relax + type);
+}
+
+TP_FUNC_INLINE index_t * mm(struct mem_t *m, index_t motor)
+{
+	return m->model->mm + motor;
+}
+
+TP_FUNC_INLINE index_t _mm(struct mem_t *m, index_t motor)
+{
+	return *(m->model->mm + motor);
+}
+
+TP_FUNC_INLINE index_t * rorder(struct mem_t *m, index_t row)
+{
+	return m->model->rorder + row;
+}
+
+TP_FUNC_INLINE index_t _rorder(struct mem_t *m, index_t row)
+{
+	return *(m->model->rorder + row);
+}
+
+#ifdef TP_TREE_SOLVER
+TP_FUNC_INLINE index_t * tnode(struct mem_t *m, index_t num)
+{
+	return m->tnodes + num;
+}
+
+TP_FUNC_INLINE index_t _tnode(struct mem_t *m, index_t num)
+{
+	return *(m->tnodes + num);
+}
+
+TP_FUNC_INLINE index_t * tparent(struct mem_t *m, index_t node)
+{
+	return m->tparent + node;
+}
+
+TP_FUNC_INLINE index_t _tparent(struct mem_t *m, index_t node)
+{
+	return *(m->tparent + node);
+}
+#endif
+
+TP_FUNC_INLINE real_t * iniquatern(struct mem_t *m, index_t hinge_num)
+{
+	return m->model->iniq + hinge_num*TP_SIZE_VEC4;
+}
+
+#ifdef TP_DEBUG
+TP_FUNC_INLINE real_t * tFc(struct mem_t *m, index_t body)
+{
+	return m->Fc + body*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * aFc(struct mem_t *m, index_t body)
+{
+	return m->Fc + body*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * cpo(struct mem_t *m, index_t contact)
+{
+	return m->cinfo + contact*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * cno(struct mem_t *m, index_t contact)
+{
+	return m->cinfo + contact*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE real_t * cpl0(struct mem_t *m, index_t foot)
+{
+	return m->cplane + foot*TP_SIZE_VEC6;
+}
+
+TP_FUNC_INLINE real_t * cpl1(struct mem_t *m, index_t foot)
+{
+	return m->cplane + foot*TP_SIZE_VEC6 + 3;
+}
+
+TP_FUNC_INLINE index_t * cbdy(struct mem_t *m, index_t foot)
+{
+	return m->cbody + foot;
+}
+
+TP_FUNC_INLINE index_t _cbdy(struct mem_t *m, index_t foot)
+{
+	return *(m->cbody + foot);
+}
+#endif
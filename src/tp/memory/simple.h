@@ -17,27 +17,42 @@ struct mem_t
 	real_t mi[(TP_BODIES)];									// Inverse mass
 	real_t Ibi[(TP_BODIES)*3*TP_SIZE_VEC3];					// Inverse inertia matrix
 	real_t R[(TP_BODIES)*3*TP_SIZE_VEC3]; 					// Convenience matrix
+	real_t Iwi[(TP_BODIES)*3*TP_SIZE_VEC3];					// Inverse inertia matrix, world frame
 
 	real_t Fe[(TP_BODIES)*TP_SIZE_VEC6];					// External force
 
-	real_t J[2*TP_SIZE_VEC6*TP_CONSTRAINTS];				// Constraint Jacobian
+	real_t J[TP_JACOBIAN_SIZE];							// Constraint Jacobian
 
 	real_t lambda[TP_CONSTRAINTS];							// F_c = J^{T}\lambda
 	real_t lambda_min[TP_CONSTRAINTS];						// min
 	real_t lambda_max[TP_CONSTRAINTS];						// max
 
 	index_t mm[(TP_MOTORS)];								// Mapping motors->hinges
+	index_t rorder[TP_HINGE_MOTOR_CONSTRAINTS];				// Solver order of hinge and motor rows
+#ifdef TP_TREE_SOLVER
+	index_t tnodes[(TP_BODIES)+(TP_HINGES)];				// Tree nodes with parents before children
+	index_t tparent[(TP_BODIES)+(TP_HINGES)];				// Parent tree node, -1 for roots
+#endif
 	real_t mdspeed[(TP_MOTORS)];							// Desired speed for motors
+	real_t relax[3];										// Relaxation factors of hinge, motor and contact rows
 	real_t iniq[(TP_HINGES)*TP_SIZE_VEC4];					// Quaternions for initial rotations
 
 	index_t Jm[2*TP_CONSTRAINTS];							// Mapping->bodies, sparse Jacobian
-	real_t B[2*TP_SIZE_VEC6*TP_CONSTRAINTS];				// M^{-1}J^{T}, for solving
+	index_t crows[TP_CONTACT_CONSTRAINTS*(TP_FEET)];		// Active contact rows
+	index_t ncrows;											// Number of active contact rows
+	real_t B[TP_JACOBIAN_SIZE];							// M^{-1}J^{T}, for solving
 	real_t a[(TP_BODIES)*TP_SIZE_VEC6];						// B\lambda, for solving
 	real_t d[TP_CONSTRAINTS];								// diag(JB), for solving
+	real_t di[TP_CONSTRAINTS];								// 1/diag(JB), for solving
 	real_t rhs[TP_CONSTRAINTS];								// Right hand side, for solving
+#ifdef TP_BLOCK_HINGES
+	real_t Hi[(TP_HINGES)*25];								// (JB)^{-1} of hinge row blocks, for solving
+#endif
 
 	real_t haxes[(TP_HINGES)*2*TP_SIZE_VEC6];				// Hinge axis 1+2, tangent base 1
 	real_t hanchors[(TP_HINGES)*TP_SIZE_VEC6];				// Hinge anchors ( -''- )
+	real_t haxes_w[(TP_HINGES)*TP_SIZE_VEC6];				// Hinge axis 1+2, world frame
+	real_t hanchors_w[(TP_HINGES)*TP_SIZE_VEC6];			// Hinge anchors, world frame
 
 #ifdef TP_DEBUG
 	real_t Fc[(TP_BODIES)*TP_SIZE_VEC6];					// Constraint force
@@ -55,23 +70,38 @@ void zero_memory(struct mem_t *mem)
 	for(size_t i = 0; i < (TP_BODIES); ++i) mem->mi[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) mem->Ibi[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) mem->R[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_BODIES)*3*TP_SIZE_VEC3; ++i) mem->Iwi[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) mem->Fe[i] = TP_REAL(0.0);
-	for(size_t i = 0; i < 2*TP_SIZE_VEC6*TP_CONSTRAINTS; ++i) mem->J[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < TP_JACOBIAN_SIZE; ++i) mem->J[i] = TP_REAL(0.0);
 
 	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->lambda[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->lambda_min[i] = TP_REAL(-1048576.0);
 	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->lambda_max[i] = TP_REAL(1048576.0);
 
 	for(size_t i = 0; i < 2*TP_CONSTRAINTS; ++i) mem->Jm[i] = 0;
-	for(size_t i = 0; i < 2*TP_SIZE_VEC6*TP_CONSTRAINTS; ++i) mem->B[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < TP_CONTACT_CONSTRAINTS*(TP_FEET); ++i) mem->crows[i] = 0;
+	mem->ncrows = 0;
+	for(size_t i = 0; i < TP_JACOBIAN_SIZE; ++i) mem->B[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < (TP_BODIES)*TP_SIZE_VEC6; ++i) mem->a[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->d[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->di[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < TP_CONSTRAINTS; ++i) mem->rhs[i] = TP_REAL(0.0);
+#ifdef TP_BLOCK_HINGES
+	for(size_t i = 0; i < (TP_HINGES)*25; ++i) mem->Hi[i] = TP_REAL(0.0);
+#endif
 	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) mem->hanchors[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) mem->hanchors_w[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC6; ++i) mem->haxes_w[i] = TP_REAL(0.0);
 	for(size_t i = 0; i < (TP_HINGES)*2*TP_SIZE_VEC6; ++i) mem->haxes[i] = TP_REAL(0.0);
 
 	for(size_t i = 0; i < (TP_MOTORS); ++i) mem->mm[i] = 0;
+	for(size_t i = 0; i < TP_HINGE_MOTOR_CONSTRAINTS; ++i) mem->rorder[i] = i;
+#ifdef TP_TREE_SOLVER
+	for(size_t i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) mem->tnodes[i] = i;
+	for(size_t i = 0; i < (TP_BODIES)+(TP_HINGES); ++i) mem->tparent[i] = -1;
+#endif
 	for(size_t i = 0; i < (TP_MOTORS); ++i) mem->mdspeed[i] = TP_REAL(0.0);
+	for(size_t i = 0; i < 3; ++i) mem->relax[i] = TP_REAL(1.0);
 	for(size_t i = 0; i < (TP_HINGES)*TP_SIZE_VEC4; ++i) mem->iniq[i] = TP_REAL(0.0);
 
 #ifdef TP_DEBUG
@@ -187,6 +217,16 @@ TP_FUNC_INLINE real_t * hanchor(struct mem_t *m, index_t hinge_num, index_t body
 	return m->hanchors + hinge_num*TP_SIZE_VEC6 + 3*body_index;
 }
 
+TP_FUNC_INLINE real_t * haxis_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->haxes_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
+TP_FUNC_INLINE real_t * hanchor_world(struct mem_t *m, index_t hinge_num, index_t body_index)
+{
+	return m->hanchors_w + hinge_num*TP_SIZE_VEC6 + 3*body_index;
+}
+
 TP_FUNC_INLINE real_t * pos(struct mem_t *m, index_t body)
 {
 	return m->q + body*(TP_SIZE_VEC3+TP_SIZE_VEC4);
@@ -226,6 +266,11 @@ TP_FUNC_INLINE real_t * Ibi(struct mem_t *m, index_t body)
 	return m->Ibi + body*3*TP_SIZE_VEC3;
 }
 
+TP_FUNC_INLINE real_t * Iwi(struct mem_t *m, index_t body)
+{
+	return m->Iwi + body*3*TP_SIZE_VEC3;
+}
+
 TP_FUNC_INLINE real_t * tFe(struct mem_t *m, index_t body)
 {
 	return m->Fe + body*TP_SIZE_VEC6;
@@ -246,24 +291,62 @@ TP_FUNC_INLINE index_t _Jm(struct mem_t *m, index_t constraint, index_t body)
 	return *(m->Jm + constraint*2 + body);
 }
 
+TP_FUNC_INLINE index_t * crow(struct mem_t *m, index_t num)
+{
+	return m->crows + num;
+}
+
+TP_FUNC_INLINE index_t _crow(struct mem_t *m, index_t num)
+{
+	return *(m->crows + num);
+}
+
+TP_FUNC_INLINE index_t * ncrows(struct mem_t *m)
+{
+	return &m->ncrows;
+}
+
+TP_FUNC_INLINE index_t _ncrows(struct mem_t *m)
+{
+	return m->ncrows;
+}
+
 TP_FUNC_INLINE real_t * tJ(struct mem_t *m, index_t constraint, index_t body)
 {
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tJ()
+	return m->J + constraint*(TP_SIZE_VEC6);
+#else
 	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
 }
 
 TP_FUNC_INLINE real_t * aJ(struct mem_t *m, index_t constraint, index_t body)
 {
+#ifdef TP_COMPACT_JACOBIAN
+	return m->J + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
 	return m->J + (constraint*2 + body)*(TP_SIZE_VEC6) + 3;
+#endif
 }
 
 TP_FUNC_INLINE real_t * tB(struct mem_t *m, index_t constraint, index_t body)
 {
+#ifdef TP_COMPACT_JACOBIAN
+	assert(constraint >= TP_HINGE_MOTOR_CONSTRAINTS);	// Not stored, see get_row_tB()
+	return m->B + constraint*(TP_SIZE_VEC6);
+#else
 	return m->B + (constraint*2 + body)*(TP_SIZE_VEC6);
+#endif
 }
 
 TP_FUNC_INLINE real_t * aB(struct mem_t *m, index_t constraint, index_t body)
 {
+#ifdef TP_COMPACT_JACOBIAN
+	return m->B + constraint*(TP_SIZE_VEC6) + ((constraint < TP_HINGE_MOTOR_CONSTRAINTS) ? 3*body : 3);
+#else
 	return m->B + (constraint*2 + body)*(TP_SIZE_VEC6)+3;
+#endif
 }
 
 TP_FUNC_INLINE real_t * ta(struct mem_t *m, index_t body)
@@ -316,6 +399,16 @@ TP_FUNC_INLINE real_t _d(struct mem_t *m, index_t constraint)
 	return *(m->d + constraint);
 }
 
+TP_FUNC_INLINE real_t * di(struct mem_t *m, index_t constraint)
+{
+	return m->di + constraint;
+}
+
+TP_FUNC_INLINE real_t _di(struct mem_t *m, index_t constraint)
+{
+	return *(m->di + constraint);
+}
+
 TP_FUNC_INLINE real_t * rhs(struct mem_t *m, index_t constraint)
 {
 	return m->rhs + constraint;
@@ -326,6 +419,18 @@ TP_FUNC_INLINE real_t _rhs(struct mem_t *m, index_t constraint)
 	return *(m->rhs + constraint);
 }
 
+#ifdef TP_BLOCK_HINGES
+TP_FUNC_INLINE real_t * Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return m->Hi + hinge*25 + row*5 + col;
+}
+
+TP_FUNC_INLINE real_t _Hi(struct mem_t *m, index_t hinge, index_t row, index_t col)
+{
+	return *(m->Hi + hinge*25 + row*5 + col);
+}
+#endif
+
 TP_FUNC_INLINE real_t * mds(struct mem_t *m, index_t motor)
 {
 	return m->mdspeed + motor;
@@ -336,6 +441,16 @@ TP_FUNC_INLINE real_t _mds(struct mem_t *m, index_t motor)
 	return *(m->mdspeed + motor);
 }
 
+TP_FUNC_INLINE real_t * relax(struct mem_t *m, index_t type)
+{
+	return m->relax + type;
+}
+
+TP_FUNC_INLINE real_t _relax(struct mem_t *m, index_t type)
+{
+	return *(m->relax + type);
+}
+
 TP_FUNC_INLINE index_t * mm(struct mem_t *m, index_t motor)
 {
 	return m->mm + motor;
@@ -346,6 +461,38 @@ TP_FUNC_INLINE index_t _mm(struct mem_t *m, index_t motor)
 	return *(m->mm + motor);
 }
 
+TP_FUNC_INLINE index_t * rorder(struct mem_t *m, index_t row)
+{
+	return m->rorder + row;
+}
+
+TP_FUNC_INLINE index_t _rorder(struct mem_t *m, index_t row)
+{
+	return *(m->rorder + row);
+}
+
+#ifdef TP_TREE_SOLVER
+TP_FUNC_INLINE index_t * tnode(struct mem_t *m, index_t num)
+{
+	return m->tnodes + num;
+}
+
+TP_FUNC_INLINE index_t _tnode(struct mem_t *m, index_t num)
+{
+	return *(m->tnodes + num);
+}
+
+TP_FUNC_INLINE index_t * tparent(struct mem_t *m, index_t node)
+{
+	return m->tparent + node;
+}
+
+TP_FUNC_INLINE index_t _tparent(struct mem_t *m, index_t node)
+{
+	return *(m->tparent + node);
+}
+#endif
+
 TP_FUNC_INLINE real_t * iniquatern(struct mem_t *m, index_t hinge_num)
 {
 	return m->iniq + hinge_num*TP_SIZE_VEC4;
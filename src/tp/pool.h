@@ -0,0 +1,233 @@
+/*
+ * pool.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <cstdlib>
+
+#ifndef TP_THREADS
+#define TP_THREADS 0
+#endif
+
+/**
+ * A persistent pool of worker threads. The workers are created once and are
+ * then woken up for every job given to the pool, so that the cost of creating
+ * threads is not paid for every step. The calling thread takes part in each
+ * job, hence a pool for @a n threads spawns @a n - 1 workers.
+ *
+ * @ingroup tp-batch
+ */
+struct pool_t
+{
+	pthread_t *workers;
+	int num_threads;
+
+	pthread_mutex_t lock;
+	pthread_cond_t job_ready;
+	pthread_cond_t job_done;
+	unsigned long generation;								// Incremented for every new job
+	int busy;												// Workers not yet finished with the job
+	bool quit;
+
+	void (*task)(void *data, size_t begin, size_t end);		// Current job
+	void *data;
+	size_t num_items;
+	size_t chunk;
+	size_t next;											// Next unclaimed item, claimed atomically
+
+	double *partials;										// Two per thread, for the reductions of a job
+};
+
+/** Processes chunks of the current job until all items are claimed.
+ *
+ * @param		pool			Pool that holds the job.
+ *
+ * @ingroup tp-batch
+ */
+inline void work_on_job(struct pool_t *pool)
+{
+	while(true)
+	{
+		size_t begin = __sync_fetch_and_add(&pool->next, pool->chunk);
+		if(begin >= pool->num_items) break;
+
+		size_t end = begin + pool->chunk;
+		if(end > pool->num_items) end = pool->num_items;
+
+		pool->task(pool->data, begin, end);
+	}
+}
+
+/** Main loop for the worker threads of a pool.
+ *
+ * @param		data			Pointer to the pool.
+ *
+ * @ingroup tp-batch
+ */
+inline void * pool_worker(void *data)
+{
+	struct pool_t *pool = (struct pool_t *)data;
+	unsigned long seen = 0;
+
+	while(true)
+	{
+		pthread_mutex_lock(&pool->lock);
+		while(pool->generation == seen && !pool->quit)
+			pthread_cond_wait(&pool->job_ready, &pool->lock);
+
+		if(pool->quit)
+		{
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		seen = pool->generation;
+		pthread_mutex_unlock(&pool->lock);
+
+		work_on_job(pool);
+
+		pthread_mutex_lock(&pool->lock);
+		if(--pool->busy == 0)
+			pthread_cond_signal(&pool->job_done);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	return NULL;
+}
+
+/** Starts the worker threads of a pool.
+ *
+ * @param		pool			Pool to initialize.
+ * @param		num_threads		Number of threads to use, including the calling thread.
+ * 								If zero or less the number of online CPU cores is used.
+ *
+ * @ingroup tp-batch
+ */
+inline void init_pool(struct pool_t *pool, int num_threads)
+{
+	if(num_threads <= 0)
+		num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if(num_threads <= 0)
+		num_threads = 1;
+
+	pool->num_threads = num_threads;
+	pool->generation = 0;
+	pool->busy = 0;
+	pool->quit = false;
+	pool->task = NULL;
+	pool->data = NULL;
+	pool->num_items = 0;
+	pool->chunk = 1;
+	pool->next = 0;
+
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->job_ready, NULL);
+	pthread_cond_init(&pool->job_done, NULL);
+
+	pool->partials = (double *)std::malloc(2*num_threads*sizeof(double));
+
+	pool->workers = (pthread_t *)std::malloc((num_threads - 1)*sizeof(pthread_t));
+	for(int t = 0; t < num_threads - 1; ++t)
+		pthread_create(&pool->workers[t], NULL, pool_worker, (void *)pool);
+}
+
+/** Stops and joins the worker threads of a pool.
+ *
+ * @param		pool			Pool to destroy.
+ *
+ * @ingroup tp-batch
+ */
+inline void destroy_pool(struct pool_t *pool)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = true;
+	pthread_cond_broadcast(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+
+	for(int t = 0; t < pool->num_threads - 1; ++t)
+		pthread_join(pool->workers[t], NULL);
+
+	std::free(pool->workers);
+	std::free(pool->partials);
+
+	pthread_cond_destroy(&pool->job_done);
+	pthread_cond_destroy(&pool->job_ready);
+	pthread_mutex_destroy(&pool->lock);
+}
+
+/** Runs a job on a pool and waits until it is completed.
+ *
+ * The items [0, @a num_items) are split into chunks that are handed out
+ * to the threads on demand, so that threads finishing early pick up more work.
+ *
+ * @param		pool			Pool to run the job on.
+ * @param		task			Function called for each chunk [@a begin, @a end) of items.
+ * @param		data			User data passed to @a task.
+ * @param		num_items		Number of items in the job.
+ * @param		chunk			Number of items claimed at a time, zero for automatic.
+ *
+ * @ingroup tp-batch
+ */
+inline void run_pool(
+		struct pool_t *pool,
+		void (*task)(void *data, size_t begin, size_t end),
+		void *data,
+		size_t num_items,
+		size_t chunk = 0)
+{
+	if(num_items == 0) return;
+
+	// Aim for a handful of chunks per thread to even out the load
+	if(chunk == 0)
+		chunk = num_items / (8*pool->num_threads);
+	if(chunk == 0)
+		chunk = 1;
+
+	if(pool->num_threads == 1 || num_items <= chunk)
+	{
+		task(data, 0, num_items);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->task = task;
+	pool->data = data;
+	pool->num_items = num_items;
+	pool->chunk = chunk;
+	pool->next = 0;
+	pool->busy = pool->num_threads - 1;
+	++pool->generation;
+	pthread_cond_broadcast(&pool->job_ready);
+	pthread_mutex_unlock(&pool->lock);
+
+	work_on_job(pool);
+
+	pthread_mutex_lock(&pool->lock);
+	while(pool->busy > 0)
+		pthread_cond_wait(&pool->job_done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/** Returns the pool used by step_worlds() when no pool is given.
+ *
+ * The pool is created at first use, with #TP_THREADS threads, and lives
+ * until the process exits.
+ *
+ * @return the default pool.
+ *
+ * @ingroup tp-batch
+ */
+inline struct pool_t * default_pool()
+{
+	static struct pool_t pool;
+	static bool initialized = (init_pool(&pool, TP_THREADS), true);
+	(void)initialized;
+
+	return &pool;
+}
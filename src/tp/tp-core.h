@@ -1,6 +1,19 @@
 
 #pragma once
 
+#ifdef TP_DYNAMIC
+#if defined(TP_BODIES) || defined(TP_HINGES) || defined(TP_MOTORS) || defined(TP_FEET)
+#error TP_DYNAMIC sets the model size at runtime, do not define TP_BODIES, TP_HINGES, TP_MOTORS or TP_FEET
+#endif
+#if defined(TP_MEM) || defined(TP_LANES) || defined(TP_TREE_SOLVER) || defined(TP_MIXED_PRECISION) || defined(TP_WORLD)
+#error TP_DYNAMIC is only implemented for memory/dynamic.h, and not for the tree or mixed precision solvers
+#endif
+#define TP_BODIES	(m->bodies)
+#define TP_HINGES	(m->hinges)
+#define TP_MOTORS	(m->motors)
+#define TP_FEET		(m->feet)
+#endif
+
 #ifndef TP_BODIES
 #error application needs to define TP_BODIES to the number of dynamcial bodies
 #define TP_BODIES 0
@@ -28,10 +41,24 @@
 #endif
 
 #define TP_CONTACTS_ON_FOOT			3
-#define TP_CONTACT_CONSTRAINTS		(TP_CONTACTS_ON_FOOT+2)
+#ifdef TP_CONTACT_TANGENTS
+#define TP_CONTACT_TANGENT_CONSTRAINTS	2
+#else
+#define TP_CONTACT_TANGENT_CONSTRAINTS	0
+#endif
+#define TP_CONTACT_CONSTRAINTS		(TP_CONTACTS_ON_FOOT+TP_CONTACT_TANGENT_CONSTRAINTS)
 #define TP_CONSTRAINTS				(5*(TP_HINGES)+(TP_MOTORS)+TP_CONTACT_CONSTRAINTS*(TP_FEET))
 #define TP_HINGE_CONSTRAINTS		(5*(TP_HINGES))
 #define TP_HINGE_MOTOR_CONSTRAINTS	(5*(TP_HINGES)+(TP_MOTORS))
+#ifdef TP_COMPACT_JACOBIAN
+#define TP_JACOBIAN_SIZE			((TP_SIZE_VEC6)*TP_CONSTRAINTS)
+#else
+#define TP_JACOBIAN_SIZE			(2*(TP_SIZE_VEC6)*TP_CONSTRAINTS)
+#endif
+
+#define TP_RELAX_HINGE				0
+#define TP_RELAX_MOTOR				1
+#define TP_RELAX_CONTACT			2
 
 #define TP_REAL(X) ((real_t)(X))
 
@@ -41,10 +68,37 @@
 
 #define TP_PI TP_REAL(3.1415926535)
 
-#ifndef TP_MEM
+#include <cassert>
+
+#if defined(TP_DYNAMIC)
+#include "memory/dynamic.h"
+#elif !defined(TP_MEM)
 #include "memory/simple.h"
 #else
 #include TP_MEM
 #endif
 #include "memory/memory.h"
+
+// TP_LANES is defined by memory/interleaved.h
+#if defined(TP_POST_STABILIZATION) && defined(TP_LANES)
+#error TP_POST_STABILIZATION is not implemented for the lanes of memory/interleaved.h
+#endif
+
+#if defined(TP_GYROSCOPIC) && defined(TP_LANES)
+#error TP_GYROSCOPIC is not implemented for the lanes of memory/interleaved.h
+#endif
+
+#if defined(TP_EXP_MAP) && defined(TP_LANES)
+#error TP_EXP_MAP is not implemented for the lanes of memory/interleaved.h
+#endif
+
+// Local arrays sized by the model, on the stack unless the memory layout has scratch space
+#ifndef TP_SCRATCH_ARRAY
+#define TP_SCRATCH_ARRAY(type, name, size)	type name[size]
+#define TP_RELEASE_SCRATCH(name)
+#endif
+
 #include "alglin.h"
+#ifdef TP_LANES
+#include "alglin_lanes.h"
+#endif
@@ -11,8 +11,18 @@
 #include "tp-core.h"
 
 #include "dynamics/inertia.h"
+#include "dynamics/kinematics.h"
 #include "dynamics/constraints.h"
+#ifdef TP_TREE_SOLVER
+#include "dynamics/tree_solver.h"
+#endif
 #include "dynamics/constraints_solver.h"
+#ifdef TP_MIXED_PRECISION
+#include "dynamics/mixed_solver.h"
+#endif
 #include "dynamics/step.h"
+#ifdef TP_LANES
+#include "dynamics/step_lanes.h"
+#endif
 #include "dynamics/feedback.h"
 #include "collision.h"
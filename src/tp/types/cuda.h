@@ -15,6 +15,7 @@
 #define TP_SIZE_VEC6	6
 
 typedef float real_t;
+typedef float sweep_real_t;
 typedef short index_t;
 typedef real_t tp_vec3[TP_SIZE_VEC3];
 typedef real_t tp_quatern[TP_SIZE_VEC4];
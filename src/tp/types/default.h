@@ -37,6 +37,13 @@ typedef float real_t;
 typedef double real_t;
 #endif
 
+/**
+ * Floating point type of the inner sweeps of the mixed precision solver, see
+ * solve_for_lambda_mixed().
+ * @ingroup tp-types
+ */
+typedef float sweep_real_t;
+
 /**
  * Abstract type for the elements in map arrays. The type for index elements
  * should be of an integer type.
@@ -118,15 +125,40 @@ typedef real_t tp_mtx33[3*TP_SIZE_VEC3];
 //@{
 /**
  * Specifier for regular simulator functions. By default the regular simulator
- * functions are not prepended by any specifier.
+ * functions are not prepended by any specifier. tp::World defines it to @a static.
  * @ingroup tp-types
  */
+#ifndef TP_FUNC
 #define TP_FUNC
+#endif
 
 /**
  * Specifier for inline simulator functions. The specifier for inline
  * functions are by default @a inline.
  * @ingroup tp-types
  */
+#ifndef TP_FUNC_INLINE
 #define TP_FUNC_INLINE inline
+#endif
+
+/**
+ * Specifier for the inline functions used by the lane-per-world kernel, see
+ * step_block(). They are forced inline so that they are compiled for the
+ * instruction set of the kernel calling them.
+ * @ingroup tp-types
+ */
+#define TP_FUNC_LANES_INLINE inline __attribute__((always_inline))
+
+/**
+ * Specifier for the lane-per-world kernel, step_block(). With GCC on x86-64
+ * the kernel is compiled for AVX-512, AVX2 and the baseline instruction set,
+ * and the version to run is picked at load time from the features of the CPU.
+ * Define TP_NO_DISPATCH to only compile the version given by the compiler flags.
+ * @ingroup tp-types
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && !defined(TP_NO_DISPATCH)
+#define TP_FUNC_LANES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define TP_FUNC_LANES
+#endif
 //@}
@@ -0,0 +1,197 @@
+/*
+ * world.h
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+
+#pragma once
+
+// Headers used by TEPE, which can not be included in the class scope of tp::World
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include "pool.h"
+
+#if defined(TP_BODIES) || defined(TP_HINGES) || defined(TP_MOTORS) || defined(TP_FEET)
+#error world.h sets the model size by template arguments, do not define TP_BODIES, TP_HINGES, TP_MOTORS or TP_FEET
+#endif
+
+#if defined(TP_TYPES) || defined(TP_LANES)
+#error world.h is only implemented for the default types and a memory layout without lanes
+#endif
+
+#define TP_WORLD
+#define TP_FUNC static
+#define TP_FUNC_INLINE static inline
+
+namespace tp
+{
+
+/**
+ * A memory arena that worlds of different models are allocated from, see
+ * init_arena() and World::create().
+ *
+ * @ingroup tp-world
+ */
+struct arena_t
+{
+	char *memory;
+	size_t size;
+	size_t used;
+};
+
+/** Allocates the memory of an arena.
+ *
+ * @param		arena			Arena to initialize.
+ * @param		size			Size of the arena in bytes.
+ *
+ * @ingroup tp-world
+ */
+inline void init_arena(struct arena_t *arena, size_t size)
+{
+	arena->memory = (char *)std::malloc(size);
+	arena->size = arena->memory ? size : 0;
+	arena->used = 0;
+}
+
+/** Frees the memory of an arena, and all that was allocated from it.
+ *
+ * @param		arena			Arena to destroy.
+ *
+ * @ingroup tp-world
+ */
+inline void destroy_arena(struct arena_t *arena)
+{
+	std::free(arena->memory);
+	arena->memory = 0;
+	arena->size = 0;
+	arena->used = 0;
+}
+
+/** Allocates from an arena.
+ *
+ * @param		arena			Arena to allocate from.
+ * @param		size			Number of bytes.
+ * @return the memory, aligned to 64 bytes, or 0 if the arena is full.
+ *
+ * @ingroup tp-world
+ */
+inline void * arena_alloc(struct arena_t *arena, size_t size)
+{
+	size_t address = (size_t)(arena->memory + arena->used);
+	size_t begin = arena->used + (((address + 63) & ~(size_t)63) - address);
+	if(begin + size > arena->size) return 0;
+
+	arena->used = begin + size;
+	return arena->memory + begin;
+}
+
+/**
+ * A simulation model of @a Bodies bodies, @a Hinges hinges, @a Motors motors and
+ * @a Feet feet. All functions of tp.h are static members, compiled for the size
+ * of the model, and the memory of a world is World::mem_t. Models of different
+ * sizes can therefore be used side by side, for example
+ * \code{.cpp}
+ * typedef tp::World<9, 8, 8, 4> quadruped;
+ * typedef tp::World<7, 6, 6, 2> biped;
+ *
+ * quadruped::mem_t *q = quadruped::create(&arena, 100);
+ * biped::mem_t *b = biped::create(&arena, 100);
+ *
+ * quadruped::step_worlds(pool, q, 100, 0.005, 20);
+ * biped::step_worlds(pool, b, 100, 0.005, 20);
+ * \endcode
+ * The tuning macros of \ref tp-usage apply to all models. world.h takes the place
+ * of tp-core.h and tp.h, which can not be included in the same translation unit.
+ *
+ * @ingroup tp-world
+ */
+template<int Bodies, int Hinges, int Motors, int Feet>
+struct World
+{
+#define TP_BODIES	Bodies
+#define TP_HINGES	Hinges
+#define TP_MOTORS	Motors
+#define TP_FEET		Feet
+
+#include "tp.h"
+
+	static const int bodies = Bodies;
+	static const int hinges = Hinges;
+	static const int motors = Motors;
+	static const int feet = Feet;
+
+	/** Number of constraint rows of the model, see #TP_CONSTRAINTS. */
+	static const int constraints = TP_CONSTRAINTS;
+
+	/** Allocates and zero initializes worlds from an arena, see zero_memory().
+	 *
+	 * @param		arena			Arena to allocate from.
+	 * @param		n				Number of worlds.
+	 * @return the worlds, or 0 if the arena is full.
+	 */
+	static struct mem_t * create(struct arena_t *arena, size_t n)
+	{
+		struct mem_t *worlds = (struct mem_t *)arena_alloc(arena, n*sizeof(struct mem_t));
+		if(!worlds) return 0;
+
+		for(size_t w = 0; w < n; ++w) zero_memory(worlds + w);
+
+		return worlds;
+	}
+
+	/** Arguments to the step_worlds() job. */
+	struct step_job_t
+	{
+		struct mem_t *worlds;
+		real_t dt;
+		int num_iterations;
+		real_t tolerance;
+	};
+
+	/** Steps a range of worlds, the task run by step_worlds(). */
+	static void step_worlds_task(void *data, size_t begin, size_t end)
+	{
+		struct step_job_t *job = (struct step_job_t *)data;
+
+		for(size_t w = begin; w < end; ++w)
+			step_world(job->worlds + w, job->dt, job->num_iterations, job->tolerance);
+	}
+
+	/** Steps a batch of worlds of the model on a thread pool, see the step_worlds() of batch.h.
+	 *
+	 * @param		pool			Pool to step the worlds on, which may be shared by all models.
+	 * @param		worlds			Array of the memory representing the worlds.
+	 * @param		n				Number of worlds.
+	 * @param		dt				Size of timestep (seconds).
+	 * @param		num_iterations	Maximum number of iterations to use in constraint force solver.
+	 * @param		tolerance		Convergence tolerance of the constraint force solver, see solve_for_lambda().
+	 */
+	static void step_worlds(
+			struct pool_t *pool,
+			struct mem_t *worlds,
+			size_t n,
+			real_t dt,
+			int num_iterations,
+			real_t tolerance = TP_REAL(0.0))
+	{
+		struct step_job_t job;
+		job.worlds = worlds;
+		job.dt = dt;
+		job.num_iterations = num_iterations;
+		job.tolerance = tolerance;
+
+		run_pool(pool, step_worlds_task, (void *)&job, n, 0);
+	}
+
+#undef TP_BODIES
+#undef TP_HINGES
+#undef TP_MOTORS
+#undef TP_FEET
+};
+
+}